@@ -5,9 +5,16 @@
  * 
  * @author Daniel Xu and the Airheads Team
  * @date 2022-Nov-28 Original file
+ * @date 2026-Oct-16 Attitude from a Mahony filter with microsecond time steps
+ * @date 2026-Oct-16 Angles found with the quick functions in fastmath.h
+ * @date 2026-Oct-16 Accel and gyro read in one raw burst on a faster bus
+ * @date 2026-Oct-16 Samples batched in the LSM6DSOX's FIFO
+ * @date 2026-Oct-16 Reads timed by the sensors' interrupt lines
  */
 #include <Arduino.h>
+#include <esp_timer.h>
 #include "IMU.h"
+#include "fastmath.h"
 #include "PrintStream.h"
 
 /// @brief Constructor for LIS3MDL object, which operates with the magnetometer
@@ -219,8 +226,61 @@ uint8_t LIS3MDL::readRegister(byte Register)
 }
 
 
+/// @brief Turns a 32-bit time, as kept by an ISR, back into a 64-bit time
+/// @param time_us The low 32 bits of a recent esp_timer_get_time()
+/// @param now_us The present esp_timer_get_time()
+/// @returns The full time, within 71 minutes before now_us
+static int64_t widen_time(uint32_t time_us, int64_t now_us)
+{
+    return now_us - (uint32_t)((uint32_t)now_us - time_us);
+}
+
+
+/// @brief Finds the slowest output data rate at least as fast as a given rate
+/// @param rate_hz Rate wanted in Hz
+/// @param period_us Set to the time between samples at that data rate in us
+/// @returns The data rate setting
+static lsm6ds_data_rate_t data_rate_for(uint16_t rate_hz, float& period_us)
+{
+    if (rate_hz <= 104) {
+        period_us = 1e6f / 104;
+        return LSM6DS_RATE_104_HZ;
+    }
+    if (rate_hz <= 208) {
+        period_us = 1e6f / 208;
+        return LSM6DS_RATE_208_HZ;
+    }
+    if (rate_hz <= 416) {
+        period_us = 1e6f / 416;
+        return LSM6DS_RATE_416_HZ;
+    }
+    if (rate_hz <= 833) {
+        period_us = 1e6f / 833;
+        return LSM6DS_RATE_833_HZ;
+    }
+    period_us = 1e6f / 1666;
+    return LSM6DS_RATE_1_66K_HZ;
+}
+
+
 /// @brief Constructor for LSM6DSOX object, which handles the accelerometer and gyroscope sensors
-LSM6DSOX::LSM6DSOX(void)
+/// @details The sensors' output data rate is set to the first one at least as
+///          fast as the rate at which they are read, so that each reading is
+///          a fresh sample and the gyro is integrated at the rate it is
+///          sampled. If IMU_USE_FIFO is true, the sensors run at least at
+///          IMU_FIFO_RATE instead and every sample is queued in the FIFO, to
+///          be filtered in a batch when update() is called. The
+///          accelerometer's range is widened to 8 g so that a
+///          hard pull-up doesn't clip it.
+///
+///          The bus is then sped up from the default 100 kHz. The LSM6DSOX
+///          runs at 1 MHz Fast-mode Plus, but the LIS3MDL is only rated for
+///          400 kHz Fast mode, so 1 MHz is used only when the magnetometer
+///          isn't on the bus or IMU_I2C_FAST_PLUS is set. If the LSM6DSOX
+///          can't be read back at 1 MHz, as with pull-ups too weak for it,
+///          the bus drops to 400 kHz.
+/// @param rate_hz Rate at which update() will be called, default set to 104 Hz
+LSM6DSOX::LSM6DSOX(uint16_t rate_hz)
 {
     // For initial setup for i2C communication, set up i2c using the Adafruit libraray method
     if (!imu.begin_I2C()) {
@@ -230,16 +290,188 @@ LSM6DSOX::LSM6DSOX(void)
         }
     }
 
-    // Set mode to start with continuous mode, which continuously collects data
-    Magno.setOperationMode(LIS3MDL_CONTINUOUSMODE);
-    // Collect data as fast as possible
-    Magno.setDataRate(LIS3MDL_DATARATE_1000_HZ);
+    // The FIFO needs the raw reads, as the Adafruit library can't read it
+    bool want_fifo = IMU_USE_FIFO && IMU_RAW_READ;
+    uint16_t sensor_hz = (want_fifo && rate_hz < IMU_FIFO_RATE) ? IMU_FIFO_RATE : rate_hz;
+    lsm6ds_data_rate_t rate = data_rate_for(sensor_hz, nominal_period_us);
+    sample_period_us = nominal_period_us;
+    imu.setAccelDataRate(rate);
+    imu.setGyroDataRate(rate);
+    imu.setAccelRange(LSM6DS_ACCEL_RANGE_8_G);
+    find_scales();
+
+    // Without the magnetometer the filter still finds pitch and roll; only
+    // the yaw drifts
+    mag_found = Magno.begin_I2C();
+    if (mag_found) {
+        // Set mode to start with continuous mode, which continuously collects data
+        Magno.setOperationMode(LIS3MDL_CONTINUOUSMODE);
+        // The magnetometer only corrects the heading, slowly, so 155 Hz is
+        // plenty and keeps its data ready interrupts few
+        Magno.setDataRate(LIS3MDL_DATARATE_155_HZ);
+    }
+    else {
+        Serial.println("LIS3MDL not found; yaw from the gyro alone");
+    }
+
+    bus_clock = (mag_found && !IMU_I2C_FAST_PLUS) ? I2C_FAST_CLOCK : I2C_FAST_PLUS_CLOCK;
+    p_i2c->setClock(bus_clock);
+    if (bus_clock > I2C_FAST_CLOCK && readRegister(_WHO_AM_I) != _CHIP_ID) {
+        bus_clock = I2C_FAST_CLOCK;
+        p_i2c->setClock(bus_clock);
+    }
+
+    if (want_fifo) {
+        // A gyro and an accel word for each whole sample between calls to
+        // update(), so that a watermark interrupt comes at least that often
+        uint16_t samples = (uint16_t)(1e6f / (nominal_period_us * rate_hz));
+        fifo_watermark = 2 * ((samples > 0) ? samples : 1);
+        fifo_on = start_fifo(rate, fifo_watermark);
+        if (!fifo_on) {
+            Serial.println("LSM6DSOX FIFO not set up; reading one sample at a time");
+        }
+    }
+
+    Serial.printf("LSM6DSOX Initialized, I2C at %u kHz, %u Hz data rate%s\r\n",
+                  (unsigned)(bus_clock / 1000),
+                  (unsigned)(1e6f / nominal_period_us + 0.5f),
+                  fifo_on ? " into the FIFO" : "");
+}
+
+
+/// @brief Writes a register of the LSM6DSOX
+/// @param Register Register address to write to
+/// @param RegData Data to write to address
+/// @returns True if the LSM6DSOX acknowledged the write
+bool LSM6DSOX::writeRegister(byte Register, byte RegData)
+{
+    p_i2c->beginTransmission(address);
+    p_i2c->write(Register);
+    p_i2c->write(RegData);
+    return p_i2c->endTransmission() == 0;
+}
+
+
+/// @brief Reads a register of the LSM6DSOX
+/// @param Register Register to read from
+/// @returns Reading from register, or 0xFF if it couldn't be read
+uint8_t LSM6DSOX::readRegister(byte Register)
+{
+    uint8_t _reading = 0xFF;
+    readRegisters(Register, &_reading, 1);
+    return _reading;
+}
+
+
+/// @brief Reads consecutive registers of the LSM6DSOX in one burst
+/// @details The register address steps on by itself through a multi-byte
+///          read, so one transaction fetches them all. From the last FIFO
+///          output register it goes back to FIFO_DATA_OUT_TAG, so a burst
+///          from there reads one FIFO word after another.
+/// @param Register First register to read from
+/// @param p_data Pointer to the place to put the readings
+/// @param size Number of registers to read, at most the Wire library's buffer size
+/// @returns True if all the registers were read
+bool LSM6DSOX::readRegisters(byte Register, uint8_t* p_data, uint8_t size)
+{
+    p_i2c->beginTransmission(address);
+    p_i2c->write(Register);
+    if (p_i2c->endTransmission(false) != 0)
+    {
+        return false;
+    }
+    return p_i2c->requestFrom(address, size) == size
+           && p_i2c->readBytes(p_data, size) == size;
+}
+
+
+/// @brief Finds the scales of the raw readings from the ranges in use
+/// @details The sensitivities are those in the LSM6DSOX datasheet, table 3,
+///          turned into SI units once here so that each reading takes only a
+///          multiply per axis.
+void LSM6DSOX::find_scales(void)
+{
+    // Accelerometer sensitivity (mg per bit)
+    float mg_per_bit;
+    switch (imu.getAccelRange()) {
+        case LSM6DS_ACCEL_RANGE_2_G:
+            mg_per_bit = 0.061;
+            break;
+        case LSM6DS_ACCEL_RANGE_4_G:
+            mg_per_bit = 0.122;
+            break;
+        case LSM6DS_ACCEL_RANGE_8_G:
+            mg_per_bit = 0.244;
+            break;
+        default:
+            mg_per_bit = 0.488;
+            break;
+    }
+    accel_scale = mg_per_bit * STANDARD_GRAVITY / 1000;
+
+    // Gyro sensitivity (mdps per bit)
+    float mdps_per_bit;
+    switch (imu.getGyroRange()) {
+        case LSM6DS_GYRO_RANGE_125_DPS:
+            mdps_per_bit = 4.375;
+            break;
+        case LSM6DS_GYRO_RANGE_250_DPS:
+            mdps_per_bit = 8.75;
+            break;
+        case LSM6DS_GYRO_RANGE_500_DPS:
+            mdps_per_bit = 17.5;
+            break;
+        case LSM6DS_GYRO_RANGE_1000_DPS:
+            mdps_per_bit = 35;
+            break;
+        default:
+            mdps_per_bit = 70;
+            break;
+    }
+    gyro_scale = mdps_per_bit * RAD_PER_DEG / 1000;
+}
+
+
+/// @brief Reads the gyro and accelerometer in one raw burst
+/// @details The six outputs lie in twelve registers from OUTX_L_G, gyro
+///          first, so one burst fetches them all. Unlike the Adafruit
+///          library, the temperature isn't read.
+/// @param GYRO_X Reference parameter for Gyro X reading in rad/s
+/// @param GYRO_Y Reference parameter for Gyro Y reading in rad/s
+/// @param GYRO_Z Reference parameter for Gyro Z reading in rad/s
+/// @param ACCEL_X Reference parameter for Accelerometer X reading in m/s^2
+/// @param ACCEL_Y Reference parameter for Accelerometer Y reading in m/s^2
+/// @param ACCEL_Z Reference parameter for Accelerometer Z reading in m/s^2
+/// @returns True if all twelve bytes were read
+bool LSM6DSOX::read_raw(float& GYRO_X, float& GYRO_Y,float& GYRO_Z,float& ACCEL_X, float& ACCEL_Y,float& ACCEL_Z)
+{
+    uint8_t reading[12];
+    if (!readRegisters(_OUTX_L_G, reading, 12))
+    {
+        return false;
+    }
+
+    int16_t raw[6];
+    for (uint8_t idx = 0; idx < 6; idx++)
+    {
+        raw[idx] = (int16_t)(reading[2*idx + 1] << 8 | reading[2*idx]);
+    }
 
-    Serial.println("LSM6DSOX Initialized");
+    GYRO_X = raw[0] * gyro_scale;
+    GYRO_Y = raw[1] * gyro_scale;
+    GYRO_Z = raw[2] * gyro_scale;
+    ACCEL_X = raw[3] * accel_scale;
+    ACCEL_Y = raw[4] * accel_scale;
+    ACCEL_Z = raw[5] * accel_scale;
+    return true;
 }
 
 
 /// @brief Reads the data for gyroscope and accelerometer
+/// @details The raw burst read is used unless IMU_RAW_READ is false; if it
+///          fails, the reading is taken through the Adafruit library
+///          instead. The time the read takes is kept for get_read_us(), so
+///          the two ways may be compared.
 /// @param GYRO_X Reference parameter for Gyro X reading in rad/s
 /// @param GYRO_Y Reference parameter for Gyro Y reading in rad/s
 /// @param GYRO_Z Reference parameter for Gyro Z reading in rad/s
@@ -248,6 +480,18 @@ LSM6DSOX::LSM6DSOX(void)
 /// @param ACCEL_Z Reference parameter for Accelerometer Z reading in m/s^2
 void LSM6DSOX::read_data(float& GYRO_X, float& GYRO_Y,float& GYRO_Z,float& ACCEL_X, float& ACCEL_Y,float& ACCEL_Z)
 {
+    int64_t start_us = esp_timer_get_time();
+
+    if (IMU_RAW_READ)
+    {
+        if (read_raw(GYRO_X, GYRO_Y, GYRO_Z, ACCEL_X, ACCEL_Y, ACCEL_Z))
+        {
+            read_us = (uint32_t)(esp_timer_get_time() - start_us);
+            return;
+        }
+        raw_failures++;
+    }
+
     sensors_event_t accel;
     sensors_event_t gyro;
     sensors_event_t temp;
@@ -264,71 +508,264 @@ void LSM6DSOX::read_data(float& GYRO_X, float& GYRO_Y,float& GYRO_Z,float& ACCEL
     GYRO_Y = gyro.gyro.y;
     GYRO_Z = gyro.gyro.z;
 
+    read_us = (uint32_t)(esp_timer_get_time() - start_us);
 }
 
 
-/// @brief Calculates the pitch, yaw, and roll from sensor data
-/// @param new_time Time at which the function is called using time.h
-/// @param pitch_in Reference parameter to pitch
-/// @param yaw_in Reference parameter to yaw
-/// @param roll_in Reference parameter for roll_in
-void LSM6DSOX::get_angle(float new_time, float& pitch_in, float& yaw_in, float& roll_in)
+/// @brief Sets up the FIFO for the gyro and accelerometer
+/// @details Both sensors are batched at their output data rate in continuous
+///          mode, in which a full FIFO drops its oldest words. The settings
+///          of lsm6ds_data_rate_t are the same as the FIFO's batch data rate
+///          codes. The watermark flag rises when the FIFO holds the number of
+///          words expected between reads.
+/// @param rate The output data rate of both sensors
+/// @param watermark The number of words at which the watermark flag rises
+/// @returns True if the FIFO was set up
+bool LSM6DSOX::start_fifo(lsm6ds_data_rate_t rate, uint16_t watermark)
 {
-    // Read magnetometer data
-    sensors_event_t event; 
-    Magno.getEvent(&event);
-    MAGX = event.magnetic.x;
-    MAGY = event.magnetic.y;
-    MAGZ = event.magnetic.z;
-
-
-    // https://www.analog.com/en/app-notes/an-1057.html
-    float theta, psi, phi;
-    //
-    if(last_time == 0)
+    // Bypass mode empties the FIFO before it is set up
+    bool ok = writeRegister(_FIFO_CTRL4, 0)
+              && writeRegister(_FIFO_CTRL1, watermark & 0xFF)
+              && writeRegister(_FIFO_CTRL2, (watermark >> 8) & 0x01)
+              && writeRegister(_FIFO_CTRL3, (rate << 4) | rate)
+              && writeRegister(_FIFO_CTRL4, _FIFO_CONTINUOUS);
+    return ok && readRegister(_FIFO_CTRL4) == _FIFO_CONTINUOUS;
+}
+
+
+/// @brief Routes data ready or the FIFO watermark to the INT1 pin
+/// @details With the FIFO in use, INT1 rises when the FIFO reaches its
+///          watermark; otherwise it rises when a new gyro sample is ready.
+///          Either way it stays high until the data is read, so the rising
+///          edge marks the sample's time.
+/// @returns True if the LSM6DSOX acknowledged the setting
+bool LSM6DSOX::route_int1(void)
+{
+    return writeRegister(_INT1_CTRL, fifo_on ? _INT1_FIFO_TH : _INT1_DRDY_G);
+}
+
+
+/// @brief Reads every sample in the FIFO and runs each through the filter
+/// @details The FIFO holds seven byte words: a tag saying which sensor the
+///          word is from, with a two bit counter of the time slot, then the
+///          three axes. A gyro word and an accel word from the same slot make
+///          one sample. The words are read in bursts of FIFO_WORDS_PER_READ.
+///
+///          The samples carry no time of their own. If the time at which INT1
+///          rose is given, the sample which brought the FIFO to its watermark
+///          is taken to be from that time; otherwise the newest sample is
+///          taken to be from the time of the read. The others are spaced one
+///          sample period apart. The period is measured from the number of
+///          samples which arrive between reads, as the sensor's clock may be
+///          off by a few percent from its nominal rate.
+/// @param int1_us Low 32 bits of the time at which INT1 rose, or 0 if unknown
+void LSM6DSOX::drain_fifo(uint32_t int1_us)
+{
+    int64_t start_us = esp_timer_get_time();
+    batch_size = 0;
+
+    uint8_t status[2];
+    if (!readRegisters(_FIFO_STATUS1, status, 2))
+    {
+        read_us = (uint32_t)(esp_timer_get_time() - start_us);
+        return;
+    }
+    uint16_t words = ((status[1] & 0x03) << 8) | status[0];
+    bool overrun = status[1] & 0x40;
+    if (overrun)
     {
-        last_time = new_time;
+        fifo_overruns++;
+    }
+
+    uint16_t samples = (words + (pending_tags ? 1 : 0)) / 2;
+    uint16_t anchor = (samples > 0) ? samples - 1 : 0;
+    int64_t anchor_us = start_us;
+    if (int1_us != 0)
+    {
+        uint16_t watermark_sample = fifo_watermark / 2 - 1;
+        anchor = (watermark_sample < anchor) ? watermark_sample : anchor;
+        anchor_us = widen_time(int1_us, start_us);
+    }
+    int64_t first_us = anchor_us - (int64_t)(anchor * sample_period_us);
+
+    uint8_t data[FIFO_WORDS_PER_READ * 7];
+    while (words > 0)
+    {
+        uint8_t count = (words < FIFO_WORDS_PER_READ) ? words : FIFO_WORDS_PER_READ;
+        if (!readRegisters(_FIFO_DATA_OUT_TAG, data, count * 7))
+        {
+            break;
+        }
+        words -= count;
+
+        for (uint8_t word = 0; word < count; word++)
+        {
+            uint8_t* p_word = data + 7 * word;
+            uint8_t tag = p_word[0] >> 3;
+            uint8_t slot = (p_word[0] >> 1) & 0x03;
+            if (tag != _TAG_GYRO && tag != _TAG_ACCEL)
+            {
+                continue;
+            }
+
+            // A word from a new time slot means the partner of the pending
+            // one was lost
+            if (pending_tags && slot != pending_slot)
+            {
+                pending_tags = 0;
+            }
+            int16_t* p_axes = pending + ((tag == _TAG_GYRO) ? 0 : 3);
+            for (uint8_t idx = 0; idx < 3; idx++)
+            {
+                p_axes[idx] = (int16_t)(p_word[2*idx + 2] << 8 | p_word[2*idx + 1]);
+            }
+            pending_tags |= tag;
+            pending_slot = slot;
+            if (pending_tags != (_TAG_GYRO | _TAG_ACCEL))
+            {
+                continue;
+            }
+            pending_tags = 0;
+
+            GyroX = pending[0] * gyro_scale;
+            GyroY = pending[1] * gyro_scale;
+            GyroZ = pending[2] * gyro_scale;
+            AccelX = pending[3] * accel_scale;
+            AccelY = pending[4] * accel_scale;
+            AccelZ = pending[5] * accel_scale;
+
+            // Keep the time steps positive if the period measured is a
+            // little long
+            int64_t time_us = first_us + (int64_t)(batch_size * sample_period_us);
+            int64_t half_period_us = (int64_t)(sample_period_us / 2);
+            if (last_time_us != 0 && time_us < last_time_us + half_period_us)
+            {
+                time_us = last_time_us + half_period_us;
+            }
+            float dt = (last_time_us == 0) ? 0 : (time_us - last_time_us) * 1e-6f;
+            last_time_us = time_us;
+
+            filter.update(GyroX, GyroY, GyroZ, AccelX, AccelY, AccelZ,
+                          MagX, MagY, MagZ, dt);
+            batch_size++;
+        }
+    }
+
+    // Measure the sample period, skipping reads after samples were lost and
+    // any which are far from the nominal period
+    if (batch_size > 0 && last_drain_us != 0 && !overrun)
+    {
+        float measured = (start_us - last_drain_us) / (float)batch_size;
+        if (fabsf(measured - nominal_period_us) < 0.2f * nominal_period_us)
+        {
+            sample_period_us += (measured - sample_period_us) / 16;
+        }
+    }
+    last_drain_us = start_us;
+
+    read_us = (uint32_t)(esp_timer_get_time() - start_us);
+}
+
+
+/// @brief Reads the sensors and runs them through the attitude filter
+/// @details The time step is measured with esp_timer_get_time() between one
+///          reading and the next, so jitter in the task's timing doesn't
+///          become an error in the angles. The first reading only sets the
+///          starting attitude. With the FIFO in use, every sample taken since
+///          the last call is filtered, each with its own time step.
+///
+///          When update() is called because INT1 rose, the time it rose is
+///          the time the data was ready, which is better than the time of the
+///          read. The magnetometer is only read when its DRDY line says it
+///          has new data; until then its last reading is used again.
+/// @param int1_us Low 32 bits of the esp_timer_get_time() at which INT1 rose,
+///        or 0 if the call wasn't caused by INT1
+/// @param mag_ready Whether the magnetometer has new data
+void LSM6DSOX::update(uint32_t int1_us, bool mag_ready)
+{
+    // Read magnetometer data; zeros tell the filter it has none
+    if (mag_found && mag_ready)
+    {
+        sensors_event_t event; 
+        Magno.getEvent(&event);
+        MagX = event.magnetic.x;
+        MagY = event.magnetic.y;
+        MagZ = event.magnetic.z;
+    }
+
+    if (fifo_on)
+    {
+        drain_fifo(int1_us);
     }
     else
     {
-        // used to find change in time to use in integrating gyroscope
-        float dt = difftime(new_time, last_time);
-        
         // read data values for gyro and accelerometer
         read_data(GyroX, GyroY, GyroZ, AccelX, AccelY, AccelZ);
+        int64_t now_us = esp_timer_get_time();
+        if (int1_us != 0)
+        {
+            now_us = widen_time(int1_us, now_us);
+        }
+        float dt = (last_time_us == 0) ? 0 : (now_us - last_time_us) * 1e-6f;
+        last_time_us = now_us;
 
-        // calculate phi and psi for pitch and roll
-        // phi is used to determine pitch
-        // psi is used to determine roll
-        phi = atan2(AccelX,(sqrt(AccelY*AccelY + AccelZ*AccelZ)));
-        psi = atan2(AccelY,(sqrt(AccelX*AccelX + AccelZ*AccelZ)));
-        
-
-        // Calculate pitch and roll
-        // Equations for both integration of gyroscope with accelerometer
-        // and equations that do not use gyroscope
-
-        // equations with gyro integration
-        // pitch_in = 0.98*(pitch + GyroX*dt) + 0.02*phi - pitch_offset; 
-        // roll_in = 0.98*(roll + GyroY*dt) + 0.02*psi - roll_offset;   
-
-        // equations without gyro integration   
-        pitch_in = round((0.00*(pitch + GyroX*dt) + 1.00*phi - pitch_offset) * 180/M_PI) * M_PI/180;
-        roll_in = round((0.00*(roll + GyroY*dt) + 1.00*psi - roll_offset) * 180/M_PI) * M_PI/180;
-
-        // Calculates new Magnetometer angles with tilt compensations
-        nMAGX = MAGX*cos(pitch) + MAGZ*sin(pitch);
-        nMAGY = MAGX*sin(roll) * sin(pitch) + MAGZ*sin(roll)*cos(pitch);
-        
-        // calculates yaw using new magnetometer readings
-        yaw_in = atan2(-nMAGY,nMAGX) - yaw_offset;
-
-        // sets pitch, roll, and yaw to be stored for future use
-        pitch = pitch_in;
-        roll = roll_in;
-        yaw = yaw_in;
+        filter.update(GyroX, GyroY, GyroZ, AccelX, AccelY, AccelZ,
+                      MagX, MagY, MagZ, dt);
     }
-    last_time = new_time;
+
+    // Pitch and roll are found from the filtered direction of gravity with
+    // the same formulas which were used on the accelerometer alone
+    float grav_x, grav_y, grav_z;
+    filter.get_gravity(grav_x, grav_y, grav_z);
+    pitch = fast_atan2(grav_x, fast_sqrt(grav_y*grav_y + grav_z*grav_z));
+    roll = fast_atan2(grav_y, fast_sqrt(grav_x*grav_x + grav_z*grav_z));
+    yaw = filter.get_heading();
+}
+
+
+/// @brief Returns the pitch, yaw, and roll found by the last call to update()
+/// @param pitch_in Reference parameter to pitch in radians
+/// @param yaw_in Reference parameter to yaw in radians, from the zeroed heading
+/// @param roll_in Reference parameter for roll in radians
+void LSM6DSOX::get_angle(float& pitch_in, float& yaw_in, float& roll_in)
+{
+    pitch_in = pitch;
+    roll_in = roll;
+
+    // Keep the yaw between -pi and pi after taking off the offset, in
+    // float so that nothing is done in double precision
+    const float HALF_TURN = 3.14159265f;
+    yaw_in = yaw - yaw_offset;
+    if (yaw_in > HALF_TURN)
+    {
+        yaw_in -= 2*HALF_TURN;
+    }
+    else if (yaw_in < -HALF_TURN)
+    {
+        yaw_in += 2*HALF_TURN;
+    }
+}
+
+
+/// @brief Returns the gyroscope rates read during the last call to update()
+/// @param pitch_rate Reference parameter for pitch rate in rad/s
+/// @param yaw_rate Reference parameter for yaw rate in rad/s
+/// @param roll_rate Reference parameter for roll rate in rad/s
+void LSM6DSOX::get_rates(float& pitch_rate, float& yaw_rate, float& roll_rate)
+{
+    // Same axes as the angles from update()
+    pitch_rate = GyroX;
+    roll_rate = GyroY;
+    yaw_rate = GyroZ;
+}
+
+
+/// @brief Changes the attitude filter's gains
+/// @param kp Proportional gain of the filter's correction in rad/s
+/// @param ki Integral gain of the filter's correction in rad/s^2
+void LSM6DSOX::set_gains(float kp, float ki)
+{
+    filter.set_gains(kp, ki);
 }
 
 
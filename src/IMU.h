@@ -5,6 +5,10 @@
  * 
  * @author Daniel Xu and the Airheads Team
  * @date 2022-Nov-28 Original file
+ * @date 2026-Oct-16 Attitude from a Mahony filter with microsecond time steps
+ * @date 2026-Oct-16 Accel and gyro read in one raw burst on a faster bus
+ * @date 2026-Oct-16 Samples batched in the LSM6DSOX's FIFO
+ * @date 2026-Oct-16 Reads timed by the sensors' interrupt lines
  */
 
 #ifndef _IMU_H_
@@ -15,7 +19,29 @@
 #include "PrintStream.h"
 #include <Adafruit_LSM6DSOX.h>
 #include <Adafruit_LIS3MDL.h>
-#include <time.h>
+#include "attitudefilter.h"
+
+// IMU bus options. These may be changed with -D options in the build_flags of
+// platformio.ini
+#ifndef IMU_RAW_READ
+#define IMU_RAW_READ true           ///< Read the accel and gyro in one raw burst, not through the Adafruit library
+#endif
+#ifndef IMU_I2C_FAST_PLUS
+#define IMU_I2C_FAST_PLUS false     ///< Run the bus at 1 MHz even with the LIS3MDL, which is rated for 400 kHz, on it
+#endif
+#ifndef IMU_USE_FIFO
+#define IMU_USE_FIFO true           ///< Batch samples in the LSM6DSOX's FIFO and filter them all on each read
+#endif
+#ifndef IMU_FIFO_RATE
+#define IMU_FIFO_RATE 416           ///< Output data rate of the accel and gyro when the FIFO is used (Hz)
+#endif
+
+/// FIFO words fetched in one I2C read; seven bytes each, to fit the ESP32
+/// Wire library's 128 byte buffer
+#define FIFO_WORDS_PER_READ 18
+
+#define I2C_FAST_CLOCK 400000       ///< I2C Fast-mode clock (Hz)
+#define I2C_FAST_PLUS_CLOCK 1000000 ///< I2C Fast-mode Plus clock, which the LSM6DSOX supports (Hz)
 
 /// @brief Class to interface with the LIS3MDL magnetometer
 class LIS3MDL
@@ -74,30 +100,124 @@ class LSM6DSOX
 private:
     Adafruit_LSM6DSOX imu;                                  ///< Create object to use Adafruit libraries
     Adafruit_LIS3MDL Magno;                                 ///< Create object to use Adafruit libraries
-    float GyroX, GyroY, GyroZ, AccelX, AccelY, AccelZ;      ///< Initializing variables to get gyro and accel data
+    bool mag_found = false;                                 ///< Whether the magnetometer answered
+
+    // Register addresses and values
+    const byte _FIFO_CTRL1 = 0x07;                          ///< "FIFO_CTRL1" address, watermark LSB
+    const byte _FIFO_CTRL2 = 0x08;                          ///< "FIFO_CTRL2" address, watermark MSB
+    const byte _FIFO_CTRL3 = 0x09;                          ///< "FIFO_CTRL3" address, batch data rates
+    const byte _FIFO_CTRL4 = 0x0A;                          ///< "FIFO_CTRL4" address, FIFO mode
+    const byte _INT1_CTRL = 0x0D;                           ///< "INT1_CTRL" address, signals routed to INT1
+    const byte _WHO_AM_I = 0x0F;                            ///< "WHO_AM_I" address
+    const byte _OUTX_L_G = 0x22;                            ///< "OUTX_L_G" address, the first of the gyro then accel outputs
+    const byte _FIFO_STATUS1 = 0x3A;                        ///< "FIFO_STATUS1" address, words in the FIFO LSB
+    const byte _FIFO_STATUS2 = 0x3B;                        ///< "FIFO_STATUS2" address, words MSB and flags
+    const byte _FIFO_DATA_OUT_TAG = 0x78;                   ///< "FIFO_DATA_OUT_TAG" address, the first byte of each word
+    const byte _CHIP_ID = 0x6C;                             ///< Value read from "WHO_AM_I"
+    const byte _FIFO_CONTINUOUS = 0x06;                     ///< "FIFO_MODE" for continuous mode
+    const byte _TAG_GYRO = 0x01;                            ///< "TAG_SENSOR" of a gyro word
+    const byte _TAG_ACCEL = 0x02;                           ///< "TAG_SENSOR" of an accel word
+    const byte _INT1_DRDY_G = 0x02;                         ///< "INT1_CTRL" bit for gyro data ready
+    const byte _INT1_FIFO_TH = 0x08;                        ///< "INT1_CTRL" bit for the FIFO watermark
+
+    TwoWire* p_i2c = &Wire;                                 ///< I2C bus on which the sensors are
+    uint8_t address = LSM6DS_I2CADDR_DEFAULT;               ///< I2C address of the LSM6DSOX
+    uint32_t bus_clock = 0;                                 ///< I2C clock in use (Hz)
+    float accel_scale = 0;                                  ///< Accelerometer units per bit (m/s^2)
+    float gyro_scale = 0;                                   ///< Gyro units per bit (rad/s)
+    uint32_t read_us = 0;                                   ///< Time taken by the last accel and gyro read (us)
+    uint32_t raw_failures = 0;                              ///< Raw reads which fell back to the Adafruit library
+
+    bool fifo_on = false;                                   ///< Whether samples are read from the FIFO
+    uint16_t fifo_watermark = 0;                            ///< FIFO words expected between reads
+    float sample_period_us = 0;                             ///< Measured time between samples (us)
+    float nominal_period_us = 0;                            ///< Time between samples at the data rate set (us)
+    uint16_t batch_size = 0;                                ///< Samples in the last batch from the FIFO
+    uint32_t fifo_overruns = 0;                             ///< Times the FIFO filled and lost samples
+    int64_t last_drain_us = 0;                              ///< Time of the last read of the FIFO (us)
+    int16_t pending[6];                                     ///< Gyro then accel words waiting for their partner
+    uint8_t pending_tags = 0;                               ///< Which of the gyro and accel are pending
+    uint8_t pending_slot = 0;                               ///< Time slot of the pending words
+
+    /// @brief Header function to write a register of the LSM6DSOX
+    bool writeRegister(byte Register, byte RegData);
+    /// @brief Header function to read a register of the LSM6DSOX
+    uint8_t readRegister(byte Register);
+    /// @brief Header function to read consecutive registers in one burst
+    bool readRegisters(byte Register, uint8_t* p_data, uint8_t size);
+    /// @brief Header function to find the scales of the raw readings from the ranges in use
+    void find_scales(void);
+    /// @brief Header function to read gyro and accelerometer data in one raw burst
+    bool read_raw(float& GYRO_X, float& GYRO_Y,float& GYRO_Z,float& ACCEL_X, 
+                  float& ACCEL_Y,float& ACCEL_Z);
+    /// @brief Header function to set up the FIFO for the gyro and accelerometer
+    bool start_fifo(lsm6ds_data_rate_t rate, uint16_t watermark);
+    /// @brief Header function to read every sample in the FIFO into the filter
+    void drain_fifo(uint32_t int1_us);
+
+    MahonyFilter filter;                                    ///< Fuses the sensors into an attitude
+    float GyroX = 0, GyroY = 0, GyroZ = 0;                  ///< Initializing variables to get gyro data
+    float AccelX, AccelY, AccelZ;                           ///< Initializing variables to get accel data
+    float MagX = 0, MagY = 0, MagZ = 0;                     ///< Latest magnetometer data, zero if none
     float pitch = 0;                                        ///< Initial value for pitch
     float yaw = 0;                                          ///< Initial value for yaw
     float roll = 0;                                         ///< Initial value for roll
-    float last_time = 0;
-    int16_t MAGX, MAGY, MAGZ;                               ///< Initialize for raw MAG X, Y, and Z data
-    int16_t nMAGX, nMAGY, nMAGZ;                            ///< Initialize for tilt compensated MAG X, Y, and Z data
+    int64_t last_time_us = 0;                               ///< Time of the last reading (us)
 
     float yaw_offset = 0;                                   ///< Initial value for yaw offset
-    float roll_offset = 0;                                  ///< Initial value for roll offset
-    float pitch_offset= 0;                                  ///< Initial value for pitch offset
     
 
 
 public:
     /// @brief Header function for LSM6DSOX to initialize object  
-    LSM6DSOX(void);
+    LSM6DSOX(uint16_t rate_hz = 104);
 
     /// @brief Header function to read gyro and accelerometer data
     void read_data(float& GYRO_X, float& GYRO_Y,float& GYRO_Z,float& ACCEL_X, 
                     float& ACCEL_Y,float& ACCEL_Z);
 
+    /// @brief Header function to route data ready or the FIFO watermark to the INT1 pin
+    bool route_int1(void);
+
+    /// @brief Header function to read the sensors and run them through the filter
+    void update(uint32_t int1_us = 0, bool mag_ready = true);
+
     /// @brief Header function to get pitch, yaw, and roll data
-    void get_angle(float time, float& pitch, float& yaw, float& roll);
+    void get_angle(float& pitch, float& yaw, float& roll);
+
+    /// @brief Header function to get the gyro rates used for the last angles
+    void get_rates(float& pitch_rate, float& yaw_rate, float& roll_rate);
+
+    /// @brief Returns the time of the last reading in microseconds
+    uint32_t get_time_us(void) { return (uint32_t)last_time_us; }
+
+    /// @brief Returns the bus time taken by the last update()'s accel and gyro reads in microseconds
+    /// @details With the FIFO in use this is the whole drain: the status read and every burst
+    uint32_t get_read_us(void) { return read_us; }
+
+    /// @brief Returns the bus time per accel and gyro sample in the last update() in microseconds
+    /// @details The time of the whole drain is shared among the samples it read, so the figure
+    ///          can be compared with a single read; it is 0 if no sample was read
+    uint32_t get_sample_read_us(void)
+    {
+        uint16_t samples = get_batch_size();
+        return (samples > 0) ? read_us / samples : 0;
+    }
+
+    /// @brief Returns the number of raw reads which fell back to the Adafruit library
+    uint32_t get_raw_failures(void) { return raw_failures; }
+
+    /// @brief Returns the I2C clock in use in Hz
+    uint32_t get_bus_clock(void) { return bus_clock; }
+
+    /// @brief Returns the number of samples filtered by the last call to update()
+    uint16_t get_batch_size(void) { return fifo_on ? batch_size : 1; }
+
+    /// @brief Returns the number of times the FIFO filled and lost samples
+    uint32_t get_fifo_overruns(void) { return fifo_overruns; }
+
+    /// @brief Header function to change the filter's gains
+    void set_gains(float kp, float ki);
 
     /// @brief Header function to zero yaw 
     void zero(void);
@@ -1,8 +1,17 @@
 /** @file PIDController.h
- *  @brief Generic PID controller class (header file)
+ *  @brief Generic PID controller class template
+ *  @details The controller can be made for @c float or for a fixed-point type
+ *           such as @c Q16_16 from @c fixedpoint.h, which needs no FPU; its
+ *           speed and its use in an ISR haven't been tested on the ESP32.
+ *           Everything which depends only on the gains and the sampling
+ *           interval, such as @c Ki*dt and @c Kd/dt, is worked out when the
+ *           gains are set, so an update takes only multiplications and
+ *           additions.
  *  @author Shea Charkowsky and ME 507 Airheads team, based on format
  *  by Kane Stoboi and John Ridgely and method by Siyuan Xing
  *  @date 2022-Nov-03
+ *  @date 2026-Oct-16 Made a template on the number type, with precomputed
+ *                    gain products
  */
 
 #ifndef _CONTROLLER_H_
@@ -10,27 +19,101 @@
 
 #include <Arduino.h>
 #include "taskshare.h"
+#include "fixedpoint.h"
 
 /** @brief  Class for a proportional, intergral, and derivative (PID) controller
+ *  @details The integral term is kept already multiplied by @c Ki, so changing
+ *           the gains doesn't make the output jump. With a fixed-point type
+ *           every operation saturates, so a large error or a long-running
+ *           integral clamps at the ends of the type's range instead of
+ *           wrapping around.
+ *
+ *           @section usage_pid Usage
+ *           @code{.cpp}
+ *           PIDController<float> loop (3, 0.1, 0, 50);     // Kp, Ki, Kd, dt
+ *           PIDController<Q16_16> fast_loop (3, 0.1, 0, 2);
+ *           ...
+ *           float output = loop.getCtrlOutput (measured, desired);
+ *           Q16_16 fast_output = fast_loop.getCtrlOutput (measured, desired);
+ *           @endcode
+ *  @tparam T The number type, @c float or a @c Fixed type
  */
+template <class T = float>
 class PIDController
 {
 protected:
 
-    float Kp;               ///< Proportional gain
-    float Ki;               ///< Integral gain
-    float Kd;               ///< Derivative gain
+    T Kp;                   ///< Proportional gain
+    T Ki_dt;                ///< Integral gain times the sampling interval
+    T Kd_over_dt;           ///< Derivative gain divided by the sampling interval
 
     float dt;               ///< Sampling interval
 
-    float errIntegral;      ///< Integral of error
-    float errPrev;          ///< Error at previous time
+    T errIntegral;          ///< Integral of error, times the integral gain
+    T errPrev;              ///< Error at previous time
 
 public:
     PIDController(float Kp, float Ki, float Kd, float dt);          ///< Constructor for PID Controller class
 
     void setGains(float Kp, float Ki, float Kd);                    ///< Method to set/update the controller gains
-    float getCtrlOutput(float posCurrent, float posDesired);        ///< Method to run the controller, returns controller output
+    T getCtrlOutput(T posCurrent, T posDesired);                    ///< Method to run the controller, returns controller output
 };
 
-#endif // _CONTROLLER_H_
\ No newline at end of file
+
+/** @brief Initialize PIDController class
+ *  @param Kp_in Proprotional gain
+ *  @param Ki_in Integral gain
+ *  @param Kd_in Derivative gain
+ *  @param dt_in Interval at which the controller is run
+ */
+template <class T>
+PIDController<T>::PIDController(float Kp_in, float Ki_in, float Kd_in, float dt_in)
+{
+    dt = dt_in;
+    setGains(Kp_in, Ki_in, Kd_in);
+
+    errIntegral = 0;      // Reset integral of error
+    errPrev = 0;          // Reset error at previous time
+}
+
+
+/** @brief Set gains to user-inputted values
+ *  @details The products of the gains and the sampling interval are
+ *           calculated here in @c float, then converted to @c T once.
+ *  @param Kp_in Proprotional gain
+ *  @param Ki_in Integral gain
+ *  @param Kd_in Derivative gain
+ */
+template <class T>
+void PIDController<T>::setGains(float Kp_in, float Ki_in, float Kd_in)
+{
+    Kp = T(Kp_in);
+    Ki_dt = T(Ki_in * dt);
+    Kd_over_dt = T(Kd_in / dt);
+}
+
+
+/** @brief Calculate PID control output at current time
+ *  @param posCurrent The current value or position that is being measured
+ *  @param posDesired The desired value or position that the actuator should be at
+ *  @returns The controller output
+ */
+template <class T>
+T PIDController<T>::getCtrlOutput(T posCurrent, T posDesired)
+{
+    // Calculate error
+    T err = posDesired - posCurrent;
+    // Update the integral term
+    errIntegral += Ki_dt * err;
+    // Calculate the derivative term
+    T dTerm = Kd_over_dt * (err - errPrev);
+    // Update previous error
+    errPrev = err;
+
+    // Return summation of the terms
+    return ( Kp*err
+           + errIntegral
+           + dTerm );
+}
+
+#endif // _CONTROLLER_H_
@@ -0,0 +1,80 @@
+/** @file attitude.h
+ *  @brief This file contains the structures in which the IMU task publishes
+ *         the glider's attitude, and the state of its sensor bus, to the
+ *         other tasks.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Added @c IMUStatus
+ */
+
+#ifndef _ATTITUDE_H_
+#define _ATTITUDE_H_
+
+#include <Arduino.h>
+
+/** @brief  One attitude measurement from the IMU.
+ *  @details All the fields come from the same pass through the IMU task, so a
+ *           task which reads the whole structure from one share can't mix
+ *           the pitch of one sample with the roll of another. The sequence
+ *           number goes up by one for each new sample; a reader which keeps
+ *           the last number it saw can tell a fresh sample from a repeat.
+ */
+struct AttitudeSample
+{
+    uint32_t sequence;      ///< Number of this sample, counting from 1
+    uint32_t time_us;       ///< Time at which the sample was taken (us)
+    float pitch;            ///< Pitch angle (deg)
+    float roll;             ///< Roll angle (deg)
+    float yaw;              ///< Yaw angle from the magnetometer (deg)
+    float pitch_rate;       ///< Pitch rate from the gyroscope (deg/s)
+    float roll_rate;        ///< Roll rate from the gyroscope (deg/s)
+    float yaw_rate;         ///< Yaw rate from the gyroscope (deg/s)
+};
+
+/** @brief  Figures which show how the IMU is being read.
+ *  @details These sit beside the time taken by each read, so that a change in
+ *           that time can be traced to the bus clock or to raw reads which
+ *           failed and were taken the slow way through the Adafruit library.
+ *           FIFO overruns count the times samples were lost because the IMU
+ *           task fell behind.
+ */
+struct IMUStatus
+{
+    uint32_t bus_clock;     ///< I2C clock in use (Hz)
+    uint32_t raw_failures;  ///< Raw burst reads which fell back to the library
+    uint32_t fifo_overruns; ///< Times the FIFO filled and lost samples
+    uint16_t batch_size;    ///< Samples read from the FIFO by the last pass
+};
+
+
+/** @brief   Print the IMU's bus figures on one line.
+ *  @param   status The figures to be printed
+ *  @param   printer Reference to a serial device on which to print
+ */
+inline void print_imu_status (const IMUStatus& status, Print& printer)
+{
+    printer.printf ("IMU bus %lu kHz, %lu raw reads failed, %lu FIFO overruns,"
+                    " %u samples last read\r\n",
+                    (unsigned long)(status.bus_clock / 1000),
+                    (unsigned long)status.raw_failures,
+                    (unsigned long)status.fifo_overruns,
+                    (unsigned)status.batch_size);
+}
+
+
+/** @brief   Print the IMU's bus figures as a JSON object.
+ *  @param   status The figures to be printed
+ *  @param   printer Reference to a serial device on which to print
+ */
+inline void print_imu_status_json (const IMUStatus& status, Print& printer)
+{
+    printer.printf ("{\"bus_clock\":%lu,\"raw_failures\":%lu,"
+                    "\"fifo_overruns\":%lu,\"batch_size\":%u}",
+                    (unsigned long)status.bus_clock,
+                    (unsigned long)status.raw_failures,
+                    (unsigned long)status.fifo_overruns,
+                    (unsigned)status.batch_size);
+}
+
+#endif // _ATTITUDE_H_
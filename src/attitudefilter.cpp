@@ -0,0 +1,230 @@
+/** @file    attitudefilter.cpp
+ *  @brief   Source code for a Mahony filter which finds the glider's attitude
+ *           from its gyroscope, accelerometer and magnetometer.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Uses the quick functions in fastmath.h
+ */
+
+#include "attitudefilter.h"
+#include "fastmath.h"
+
+
+/** @brief   Create a filter with the given gains.
+ *  @param   a_kp Proportional gain of the correction (rad/s)
+ *  @param   a_ki Integral gain of the correction (rad/s^2)
+ */
+MahonyFilter::MahonyFilter (float a_kp, float a_ki)
+{
+    set_gains (a_kp, a_ki);
+    reset ();
+}
+
+
+/** @brief   Change the gains.
+ *  @details A larger proportional gain follows the accelerometer and
+ *           magnetometer more closely but passes more of their noise and of
+ *           the glider's own accelerations; a smaller one leans more on the
+ *           gyroscope. An integral gain of zero stops and clears the bias
+ *           estimate.
+ *  @param   a_kp Proportional gain of the correction (rad/s)
+ *  @param   a_ki Integral gain of the correction (rad/s^2)
+ */
+void MahonyFilter::set_gains (float a_kp, float a_ki)
+{
+    kp = a_kp;
+    ki = a_ki;
+}
+
+
+/** @brief   Start again from the next accelerometer reading.
+ */
+void MahonyFilter::reset (void)
+{
+    q0 = 1;
+    q1 = q2 = q3 = 0;
+    bias_x = bias_y = bias_z = 0;
+    started = false;
+}
+
+
+/** @brief   Set the attitude straight from the accelerometer.
+ *  @details The quaternion is made from the pitch and roll at which gravity
+ *           would be measured as it is, with zero heading, so the filter
+ *           needn't take seconds to swing around from level at startup.
+ *  @param   ax Acceleration along the x axis, with the others normalized
+ *  @param   ay Acceleration along the y axis
+ *  @param   az Acceleration along the z axis
+ */
+void MahonyFilter::start (float ax, float ay, float az)
+{
+    float sin_pitch = -ax;
+    if (sin_pitch > 1)
+    {
+        sin_pitch = 1;
+    }
+    else if (sin_pitch < -1)
+    {
+        sin_pitch = -1;
+    }
+    float half_pitch = fast_atan2 (sin_pitch, fast_sqrt (1 - sin_pitch * sin_pitch)) / 2;
+    float half_roll = fast_atan2 (ay, az) / 2;
+    float sin_p, cos_p, sin_r, cos_r;
+    fast_sincos (half_pitch, sin_p, cos_p);
+    fast_sincos (half_roll, sin_r, cos_r);
+
+    q0 = cos_r * cos_p;
+    q1 = sin_r * cos_p;
+    q2 = cos_r * sin_p;
+    q3 = -sin_r * sin_p;
+    started = true;
+}
+
+
+/** @brief   Move the attitude forward by one time step.
+ *  @details The errors are the cross products of the measured directions
+ *           with those expected from the quaternion. The magnetometer's error
+ *           is kept only about the vertical, so it corrects the heading and
+ *           never the pitch or roll. A reading of all zeros from the
+ *           accelerometer or magnetometer means it has nothing to say.
+ *  @param   gx Rotation rate about the x axis (rad/s)
+ *  @param   gy Rotation rate about the y axis (rad/s)
+ *  @param   gz Rotation rate about the z axis (rad/s)
+ *  @param   ax Acceleration along the x axis (m/s^2)
+ *  @param   ay Acceleration along the y axis (m/s^2)
+ *  @param   az Acceleration along the z axis (m/s^2)
+ *  @param   mx Magnetic field along the x axis
+ *  @param   my Magnetic field along the y axis
+ *  @param   mz Magnetic field along the z axis
+ *  @param   dt Time since the last update (s)
+ */
+void MahonyFilter::update (float gx, float gy, float gz, float ax, float ay,
+                           float az, float mx, float my, float mz, float dt)
+{
+    float accel_sq = ax * ax + ay * ay + az * az;
+    float accel_norm = 0;
+    if (accel_sq > 0)
+    {
+        float inv_norm = fast_inv_sqrt (accel_sq);
+        accel_norm = accel_sq * inv_norm;
+        ax *= inv_norm;
+        ay *= inv_norm;
+        az *= inv_norm;
+        if (!started)
+        {
+            start (ax, ay, az);
+            return;
+        }
+    }
+    if (!started || !(dt > 0))
+    {
+        return;
+    }
+
+    // Expected direction of gravity
+    float vx, vy, vz;
+    get_gravity (vx, vy, vz);
+
+    // Trust the accelerometer less as the acceleration strays from 1 g
+    float trust = 0;
+    if (accel_norm > 0)
+    {
+        trust = 1 - fabsf (accel_norm / STANDARD_GRAVITY - 1) / ACCEL_TRUST_BAND;
+        if (trust < 0)
+        {
+            trust = 0;
+        }
+    }
+    float ex = trust * (ay * vz - az * vy);
+    float ey = trust * (az * vx - ax * vz);
+    float ez = trust * (ax * vy - ay * vx);
+
+    float mag_sq = mx * mx + my * my + mz * mz;
+    if (mag_sq > 0)
+    {
+        float inv_norm = fast_inv_sqrt (mag_sq);
+        mx *= inv_norm;
+        my *= inv_norm;
+        mz *= inv_norm;
+
+        // The field turned into the earth's axes, then laid into the plane
+        // of north and down, and the direction it is expected in
+        float hx = 2 * (mx * (0.5f - q2 * q2 - q3 * q3) + my * (q1 * q2 - q0 * q3)
+                        + mz * (q1 * q3 + q0 * q2));
+        float hy = 2 * (mx * (q1 * q2 + q0 * q3) + my * (0.5f - q1 * q1 - q3 * q3)
+                        + mz * (q2 * q3 - q0 * q1));
+        float bx = fast_sqrt (hx * hx + hy * hy);
+        float bz = 2 * (mx * (q1 * q3 - q0 * q2) + my * (q2 * q3 + q0 * q1)
+                        + mz * (0.5f - q1 * q1 - q2 * q2));
+        float wx = 2 * (bx * (0.5f - q2 * q2 - q3 * q3) + bz * (q1 * q3 - q0 * q2));
+        float wy = 2 * (bx * (q1 * q2 - q0 * q3) + bz * (q0 * q1 + q2 * q3));
+        float wz = 2 * (bx * (q0 * q2 + q1 * q3) + bz * (0.5f - q1 * q1 - q2 * q2));
+
+        // Only the part of the error about the vertical corrects heading
+        float mex = my * wz - mz * wy;
+        float mey = mz * wx - mx * wz;
+        float mez = mx * wy - my * wx;
+        float vertical = mex * vx + mey * vy + mez * vz;
+        ex += vertical * vx;
+        ey += vertical * vy;
+        ez += vertical * vz;
+    }
+
+    // The integral learns the gyroscope's bias
+    if (ki > 0)
+    {
+        bias_x += ki * ex * dt;
+        bias_y += ki * ey * dt;
+        bias_z += ki * ez * dt;
+    }
+    else
+    {
+        bias_x = bias_y = bias_z = 0;
+    }
+    gx += kp * ex + bias_x;
+    gy += kp * ey + bias_y;
+    gz += kp * ez + bias_z;
+
+    // Turn the quaternion by the corrected rates
+    float half_dt = dt / 2;
+    gx *= half_dt;
+    gy *= half_dt;
+    gz *= half_dt;
+    float a = q0, b = q1, c = q2;
+    q0 += -b * gx - c * gy - q3 * gz;
+    q1 += a * gx + c * gz - q3 * gy;
+    q2 += a * gy - b * gz + q3 * gx;
+    q3 += a * gz + b * gy - c * gx;
+
+    float inv_norm = fast_inv_sqrt (q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    q0 *= inv_norm;
+    q1 *= inv_norm;
+    q2 *= inv_norm;
+    q3 *= inv_norm;
+}
+
+
+/** @brief   Find the direction of gravity in the sensor's axes.
+ *  @details This is the direction in which a still accelerometer would
+ *           measure 1 g, found from the quaternion, so pitch and roll may be
+ *           found from it with the same formulas as from the accelerometer.
+ *  @param   vx Set to the x part of the unit vector
+ *  @param   vy Set to the y part of the unit vector
+ *  @param   vz Set to the z part of the unit vector
+ */
+void MahonyFilter::get_gravity (float& vx, float& vy, float& vz) const
+{
+    vx = 2 * (q1 * q3 - q0 * q2);
+    vy = 2 * (q0 * q1 + q2 * q3);
+    vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+}
+
+
+/** @brief   Find the heading about the vertical from the quaternion.
+ *  @returns The heading, from -pi to pi (rad)
+ */
+float MahonyFilter::get_heading (void) const
+{
+    return fast_atan2 (2 * (q0 * q3 + q1 * q2), 1 - 2 * (q2 * q2 + q3 * q3));
+}
@@ -0,0 +1,104 @@
+/** @file    attitudefilter.h
+ *  @brief   Headers for a Mahony filter which finds the glider's attitude
+ *           from its gyroscope, accelerometer and magnetometer.
+ *  @details The attitude is kept as a quaternion, which is turned by the
+ *           gyroscope rates each time step, so quick motions are followed
+ *           exactly. The gyroscope drifts, so the filter compares the
+ *           direction of gravity it expects with the one the accelerometer
+ *           measures, and magnetic north with the magnetometer's, and turns
+ *           the quaternion a little toward the measurements. This correction
+ *           acts like a PI controller: the proportional gain sets how quickly
+ *           the attitude is pulled toward the measurements, and the integral
+ *           gain learns the gyroscope's bias.
+ *
+ *           In a turn or the pull-up of a flare, the accelerometer measures
+ *           more than gravity alone, so the correction is faded out as the
+ *           acceleration's size moves away from 1 g. Through such moments the
+ *           attitude comes from the gyroscope alone.
+ *
+ *           See R. Mahony, T. Hamel and J.-M. Pflimlin, "Nonlinear
+ *           Complementary Filters on the Special Orthogonal Group," IEEE
+ *           Transactions on Automatic Control, 2008.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#ifndef _ATTITUDEFILTER_H_
+#define _ATTITUDEFILTER_H_
+
+#include <Arduino.h>
+
+
+// Filter gains. These may be changed with -D options in the build_flags of
+// platformio.ini
+#ifndef MAHONY_KP
+#define MAHONY_KP 1.0f              ///< Proportional gain of the correction (rad/s)
+#endif
+#ifndef MAHONY_KI
+#define MAHONY_KI 0.02f             ///< Integral gain of the correction (rad/s^2)
+#endif
+
+/** @brief  The gains of a Mahony filter, as sent from the web page.
+ */
+struct MahonyGains
+{
+    float kp;                           ///< Proportional gain (rad/s)
+    float ki;                           ///< Integral gain (rad/s^2)
+};
+
+/// The filter gains used at startup and restored by the web page
+const MahonyGains DEFAULT_MAHONY_GAINS = {MAHONY_KP, MAHONY_KI};
+
+/// Change in the size of the acceleration, as a fraction of 1 g, at which
+/// the accelerometer is no longer trusted at all
+#define ACCEL_TRUST_BAND 0.3f
+
+/// Standard gravity (m/s^2)
+#define STANDARD_GRAVITY 9.80665f
+
+
+/** @brief   Class which runs a Mahony filter on gyroscope, accelerometer and
+ *           magnetometer readings.
+ *  @details All three sensors are read in the same axes. Rates are in rad/s;
+ *           the accelerometer and magnetometer may be in any units, as only
+ *           their directions are used, but the accelerometer must be in m/s^2
+ *           for the high-g fade to work. Angles are given in radians.
+ */
+class MahonyFilter
+{
+protected:
+    float kp;                           ///< Proportional gain (rad/s)
+    float ki;                           ///< Integral gain (rad/s^2)
+    float q0, q1, q2, q3;               ///< Attitude quaternion, scalar first
+    float bias_x, bias_y, bias_z;       ///< Integral of the correction (rad/s)
+    bool started;                       ///< Whether the attitude has been set
+
+    // Set the attitude straight from the accelerometer
+    void start (float ax, float ay, float az);
+
+public:
+    // Create a filter with the given gains
+    MahonyFilter (float a_kp = MAHONY_KP, float a_ki = MAHONY_KI);
+
+    // Change the gains
+    void set_gains (float a_kp, float a_ki);
+
+    // Start again from the next accelerometer reading
+    void reset (void);
+
+    // Move the attitude forward by one time step
+    void update (float gx, float gy, float gz, float ax, float ay, float az,
+                 float mx, float my, float mz, float dt);
+
+    // Find the direction of gravity in the sensor's axes
+    void get_gravity (float& vx, float& vy, float& vz) const;
+
+    // Find the heading about the vertical from the quaternion
+    float get_heading (void) const;
+
+    /// Return whether the filter has had a reading to start from
+    bool is_started (void) const { return started; }
+};
+
+#endif // _ATTITUDEFILTER_H_
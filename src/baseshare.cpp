@@ -11,6 +11,7 @@
  *
  *  @date 2014-Oct-18 JRR Created file
  *  @date 2020-Oct-19 JRR Modified for use with Arduino/FreeRTOS platform
+ *  @date 2026-Oct-16 Added put/get counts and timing statistics
  *
  *  License:
  *    This file is copyright 2014 - 2020 by JR Ridgely and released under the
@@ -57,12 +58,42 @@ BaseShare::BaseShare (const char* p_name)
         strcpy (name, "(No Name)");
     }
 
+#if SHARE_STATS
+    // Nothing has been put into or taken from the share yet
+    put_count = 0;
+    get_count = 0;
+    last_put_time = 0;
+    max_put_interval = 0;
+    max_get_age = 0;
+#endif
+
     // Install this share in the linked list of shares
     p_next = p_newest;
     p_newest = this;
 }
 
 
+/** @brief   Print the statistics columns of a line in the list of shares.
+ *  @details This method prints the number of puts and gets, how long ago the
+ *           last put happened, the longest time between puts and the oldest
+ *           data any get has returned, then ends the line. Times are in
+ *           microseconds. Descendent classes call it from @c print_in_list()
+ *           after printing their name and type.
+ *  @param   printer Reference to a serial device on which to print
+ */
+void BaseShare::print_stats (Print& printer)
+{
+#if SHARE_STATS
+    uint32_t age = (put_count > 0) ? micros () - last_put_time : 0;
+    printer.printf ("%10lu%10lu%12lu%12lu%12lu", (unsigned long)put_count,
+                    (unsigned long)get_count, (unsigned long)age,
+                    (unsigned long)max_put_interval,
+                    (unsigned long)max_get_age);
+#endif
+    printer.println ();
+}
+
+
 /** @brief   Start the printout showing the status of all shared data items.
  *  @details This method begins printing out the status of all items in the 
  *           system's linked list of shared data items (queues, task shares, 
@@ -73,8 +104,15 @@ BaseShare::BaseShare (const char* p_name)
  */
 void print_all_shares (Print& printer)
 {
-    printer.println ("Share/Queue     Type    Max. Full");
-    printer.println ("-----------     ----    ---------");
+#if SHARE_STATS
+    printer.println ("Share/Queue     Type      Max. Full      Puts      Gets"
+                     "     Age(us) Max gap(us) Max age(us)");
+    printer.println ("-----------     ----      ---------      ----      ----"
+                     "     ------- ----------- -----------");
+#else
+    printer.println ("Share/Queue     Type      Max. Full");
+    printer.println ("-----------     ----      ---------");
+#endif
 
     BaseShare::p_newest->print_in_list (printer);
 }
\ No newline at end of file
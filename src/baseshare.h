@@ -11,6 +11,7 @@
  *
  *  @date 2014-Oct-18 JRR Created file
  *  @date 2020-Oct-19 JRR Modified for use with Arduino/FreeRTOS platform
+ *  @date 2026-Oct-16 Added put/get counts and timing statistics
  *
  *  License:
  *    This file is copyright 2014 - 2020 by JR Ridgely and released under the
@@ -41,6 +42,17 @@
     #define CHECK_IF_IN_ISR() xPortInIsrContext()
 #elif (defined STM32F4xx || defined STM32L4xx)
     #define CHECK_IF_IN_ISR() xPortIsInsideInterrupt()
+#elif defined NATIVE
+    #define CHECK_IF_IN_ISR() false
+#endif
+
+/** @brief   Set to 0, for example with @c -DSHARE_STATS=0 in the build flags,
+ *           to remove the put/get statistics from all shares and queues.
+ *  @details With the statistics in, each put or get costs one call to
+ *           @c micros() and a few integer operations.
+ */
+#ifndef SHARE_STATS
+    #define SHARE_STATS 1
 #endif
 
 
@@ -77,6 +89,59 @@ class BaseShare
          */
         static BaseShare* p_newest;
 
+#if SHARE_STATS
+        /** @brief   Statistics about the use of the shared item.
+         *  @details These are updated without any locking, so a put or get
+         *           which races with another on the other core may go
+         *           uncounted; they are for diagnostics, not for control.
+         */
+        uint32_t put_count;                 ///< Number of puts so far
+        uint32_t get_count;                 ///< Number of gets so far
+        uint32_t last_put_time;             ///< Time of the latest put (us)
+        uint32_t max_put_interval;          ///< Longest time between puts (us)
+        uint32_t max_get_age;               ///< Oldest data seen by a get (us)
+#endif
+
+        /** @brief   Record that data has been put into the shared item.
+         *  @details Descendent classes call this method from every method
+         *           which writes data. It does nothing if @c SHARE_STATS is 0.
+         */
+        void count_put (void)
+        {
+#if SHARE_STATS
+            uint32_t now = micros ();
+            if (put_count > 0 && now - last_put_time > max_put_interval)
+            {
+                max_put_interval = now - last_put_time;
+            }
+            last_put_time = now;
+            put_count++;
+#endif
+        }
+
+        /** @brief   Record that data has been read from the shared item.
+         *  @details Descendent classes call this method from every method
+         *           which reads data. The age of the data is the time since
+         *           it was put in. It does nothing if @c SHARE_STATS is 0.
+         */
+        void count_get (void)
+        {
+#if SHARE_STATS
+            // Read the put time first, so a put racing on the other core
+            // can't make the age come out negative
+            uint32_t put_time = last_put_time;
+            uint32_t age = micros () - put_time;
+            if (put_count > 0 && age > max_get_age)
+            {
+                max_get_age = age;
+            }
+            get_count++;
+#endif
+        }
+
+        // Print the statistics columns of a line in the list of shares
+        void print_stats (Print& printer);
+
     public:
         // Construct a base shared data item
         BaseShare (const char* p_name = NULL);
@@ -0,0 +1,268 @@
+/** @file    bench_fastmath.cpp
+ *  @brief   Benchmark and accuracy check of the functions in @c fastmath.h
+ *           against the library's.
+ *  @details Each function is checked over a sweep of inputs against the
+ *           library in double precision, and the largest error is printed.
+ *           Then each fast function and its library counterpart in @c float
+ *           are run many times on a table of inputs and the average number
+ *           of CPU cycles per call is printed. The square roots are timed
+ *           from the bit trick, whatever @c FAST_MATH_ROOTS is set to, so
+ *           that the results show whether it should be set. The inputs are read from, and
+ *           the outputs written to, @c volatile variables so that the
+ *           compiler can't remove the work being timed.
+ *
+ *           On the PC, build with @c "pio run -e native_bench_fastmath" and
+ *           run @c .pio/build/native_bench_fastmath/program; cycles are
+ *           counted with the time stamp counter on x86, otherwise nanoseconds
+ *           are shown. On the ESP32, upload the @c featheresp32_bench_fastmath
+ *           environment and watch the serial monitor; cycles are the CPU's
+ *           cycle count.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Added the check of @c bit_sqrt(); cycle counter moved
+ *                      to @c benchcycles.h
+ */
+
+#include <Arduino.h>
+#include "fastmath.h"
+#include "benchcycles.h"
+
+
+/// Number of calls timed in each run
+const uint32_t BENCH_CALLS = 10000;
+
+/// Number of inputs in each accuracy sweep
+const uint32_t SWEEP_POINTS = 200000;
+
+/// Inputs to the functions, which the compiler must read each time
+volatile float bench_x[64];
+volatile float bench_y[64];
+
+/// Outputs of the functions, which the compiler must write each time
+volatile float float_sink;
+
+
+/** @brief   Fill the input tables with values like the IMU's readings.
+ */
+void make_inputs (void)
+{
+    for (uint8_t index = 0; index < 64; index++)
+    {
+        bench_x[index] = 9.8f * cos (index * 0.37);
+        bench_y[index] = 2.5f * sin (index * 0.61) + 0.1f;
+    }
+}
+
+
+/** @brief   Find the largest relative error of @c bit_inv_sqrt().
+ *  @details The inputs are spaced evenly in their logarithm, so every
+ *           exponent and mantissa is tried.
+ *  @returns The largest relative error
+ */
+double check_inv_sqrt (void)
+{
+    double worst = 0;
+    for (uint32_t count = 0; count < SWEEP_POINTS; count++)
+    {
+        float x = (float)pow (10.0, -30.0 + 60.0 * count / SWEEP_POINTS);
+        double exact = 1.0 / sqrt ((double)x);
+        double error = fabs (bit_inv_sqrt (x) - exact) / exact;
+        if (error > worst)
+        {
+            worst = error;
+        }
+    }
+    return worst;
+}
+
+
+/** @brief   Find the largest relative error of @c bit_sqrt().
+ *  @details The inputs are spaced as for @c check_inv_sqrt(). Zero and
+ *           negative numbers must give exactly zero.
+ *  @returns The largest relative error, or 1 if zero or a negative number
+ *           gave anything but zero
+ */
+double check_sqrt (void)
+{
+    if (bit_sqrt (0.0f) != 0.0f || bit_sqrt (-4.0f) != 0.0f)
+    {
+        return 1;
+    }
+
+    double worst = 0;
+    for (uint32_t count = 0; count < SWEEP_POINTS; count++)
+    {
+        float x = (float)pow (10.0, -30.0 + 60.0 * count / SWEEP_POINTS);
+        double exact = sqrt ((double)x);
+        double error = fabs (bit_sqrt (x) - exact) / exact;
+        if (error > worst)
+        {
+            worst = error;
+        }
+    }
+    return worst;
+}
+
+
+/** @brief   Find the largest error of @c fast_atan2().
+ *  @details The points lie on a circle, so every angle is tried, and on
+ *           circles of several sizes.
+ *  @returns The largest error (rad)
+ */
+double check_atan2 (void)
+{
+    double worst = 0;
+    for (uint32_t count = 0; count < SWEEP_POINTS; count++)
+    {
+        double angle = 2 * M_PI * count / SWEEP_POINTS - M_PI;
+        double radius = pow (10.0, (double)(count % 7) - 3);
+        float y = (float)(radius * sin (angle));
+        float x = (float)(radius * cos (angle));
+        double error = fabs (fast_atan2 (y, x) - atan2 ((double)y, (double)x));
+
+        // Just below pi and just above -pi are the same angle
+        if (error > M_PI)
+        {
+            error = fabs (error - 2 * M_PI);
+        }
+        if (error > worst)
+        {
+            worst = error;
+        }
+    }
+    return worst;
+}
+
+
+/** @brief   Find the largest error of @c fast_sincos().
+ *  @returns The largest error of the sine or the cosine
+ */
+double check_sincos (void)
+{
+    double worst = 0;
+    for (uint32_t count = 0; count < SWEEP_POINTS; count++)
+    {
+        float angle = (float)(-100.0 + 200.0 * count / SWEEP_POINTS);
+        float sine, cosine;
+        fast_sincos (angle, sine, cosine);
+        double sine_error = fabs (sine - sin ((double)angle));
+        double cosine_error = fabs (cosine - cos ((double)angle));
+        if (sine_error > worst)
+        {
+            worst = sine_error;
+        }
+        if (cosine_error > worst)
+        {
+            worst = cosine_error;
+        }
+    }
+    return worst;
+}
+
+
+/** @brief   Time one function of one or two @c float inputs.
+ *  @details A macro rather than a function, so that the call being timed is
+ *           written out in the loop and may be inlined as it would be in use.
+ */
+#define TIME_CALLS(expression)                                           \
+    [] (void) -> float                                                   \
+    {                                                                    \
+        uint32_t start = read_cycles ();                                 \
+        for (uint32_t count = 0; count < BENCH_CALLS; count++)           \
+        {                                                                \
+            float x = bench_x[count & 63];                               \
+            float y = bench_y[count & 63];                               \
+            (void)x; (void)y;                                            \
+            float_sink = (expression);                                   \
+        }                                                                \
+        return (float)(read_cycles () - start) / BENCH_CALLS;            \
+    }
+
+
+/// @brief Sine and cosine from the library, added so both must be found
+inline float library_sincos (float angle)
+{
+    return sinf (angle) + cosf (angle);
+}
+
+
+/// @brief Sine and cosine from @c fast_sincos(), added as the library's are
+inline float quick_sincos (float angle)
+{
+    float sine, cosine;
+    fast_sincos (angle, sine, cosine);
+    return sine + cosine;
+}
+
+
+/** @brief   Run the benchmark and print the results.
+ */
+void run_benchmark (void)
+{
+    make_inputs ();
+
+    Serial.printf ("Largest errors over %u inputs:\r\n", (unsigned)SWEEP_POINTS);
+    Serial.printf ("  bit_inv_sqrt:  %.2e relative\r\n", check_inv_sqrt ());
+    Serial.printf ("  bit_sqrt:      %.2e relative\r\n", check_sqrt ());
+    Serial.printf ("  fast_atan2:    %.2e rad\r\n", check_atan2 ());
+    Serial.printf ("  fast_sincos:   %.2e\r\n", check_sincos ());
+
+    // The fabs() keeps the square roots' inputs positive
+    auto time_inv_sqrt = TIME_CALLS (1.0f / sqrtf (fabsf (x)));
+    auto time_fast_inv_sqrt = TIME_CALLS (bit_inv_sqrt (fabsf (x)));
+    auto time_sqrt = TIME_CALLS (sqrtf (fabsf (x)));
+    auto time_fast_sqrt = TIME_CALLS (bit_sqrt (fabsf (x)));
+    auto time_atan2 = TIME_CALLS (atan2f (y, x));
+    auto time_fast_atan2 = TIME_CALLS (fast_atan2 (y, x));
+    auto time_sincos = TIME_CALLS (library_sincos (x));
+    auto time_fast_sincos = TIME_CALLS (quick_sincos (x));
+
+    // Run each once to warm the caches before timing
+    time_inv_sqrt ();
+    time_fast_inv_sqrt ();
+    time_sqrt ();
+    time_fast_sqrt ();
+    time_atan2 ();
+    time_fast_atan2 ();
+    time_sincos ();
+    time_fast_sincos ();
+
+    Serial.printf ("Time per call, library and fast (" CYCLE_UNITS "):\r\n");
+    Serial.printf ("  1/sqrt:  %8.1f %8.1f\r\n",
+                   time_inv_sqrt (), time_fast_inv_sqrt ());
+    Serial.printf ("  sqrt:    %8.1f %8.1f\r\n",
+                   time_sqrt (), time_fast_sqrt ());
+    Serial.printf ("  atan2:   %8.1f %8.1f\r\n",
+                   time_atan2 (), time_fast_atan2 ());
+    Serial.printf ("  sin+cos: %8.1f %8.1f\r\n",
+                   time_sincos (), time_fast_sincos ());
+}
+
+
+#ifdef NATIVE
+/** @brief   Run the benchmark on the PC.
+ */
+int main (void)
+{
+    run_benchmark ();
+    return 0;
+}
+#else
+/** @brief   Start the serial port, then run the benchmark.
+ */
+void setup (void)
+{
+    Serial.begin (115200);
+    delay (2000);
+}
+
+
+/** @brief   Run the benchmark every few seconds.
+ */
+void loop (void)
+{
+    run_benchmark ();
+    delay (5000);
+}
+#endif
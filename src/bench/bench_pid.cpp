@@ -0,0 +1,157 @@
+/** @file    bench_pid.cpp
+ *  @brief   Benchmark of one @c PIDController update in @c float and in
+ *           @c Q16_16 fixed point.
+ *  @details Each controller is run on a made-up error signal many times and
+ *           the average number of CPU cycles per call of @c getCtrlOutput()
+ *           is printed, along with the largest difference between the two
+ *           controllers' outputs. The inputs are read from, and the outputs
+ *           written to, @c volatile variables so that the compiler can't
+ *           remove the work being timed.
+ *
+ *           On the PC, build with @c "pio run -e native_bench_pid" and run
+ *           @c .pio/build/native_bench_pid/program; cycles are counted with
+ *           the time stamp counter on x86, otherwise nanoseconds are shown.
+ *           On the ESP32, upload the @c featheresp32_bench_pid environment and
+ *           watch the serial monitor; cycles are the CPU's cycle count.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Cycle counter moved to @c benchcycles.h
+ */
+
+#include <Arduino.h>
+#include "PIDController.h"
+#include "benchcycles.h"
+
+
+/// Number of controller updates timed in each run
+const uint32_t BENCH_UPDATES = 10000;
+
+/// Inputs to the controllers, which the compiler must read each time
+volatile float bench_input[64];
+
+/// Outputs of the controllers, which the compiler must write each time
+volatile float float_sink;
+volatile int32_t fixed_sink;
+
+
+/** @brief   Fill the input table with a decaying oscillation, in degrees.
+ */
+void make_inputs (void)
+{
+    for (uint8_t index = 0; index < 64; index++)
+    {
+        bench_input[index] = 40.0 * exp (-index / 20.0) * cos (index / 3.0);
+    }
+}
+
+
+/** @brief   Time the @c float controller.
+ *  @returns The average number of cycles per update
+ */
+float time_float (void)
+{
+    PIDController<float> pid (3.0, 0.5, 0.05, 2.0);
+    float desired = 0;
+
+    uint32_t start = read_cycles ();
+    for (uint32_t count = 0; count < BENCH_UPDATES; count++)
+    {
+        float_sink = pid.getCtrlOutput (bench_input[count & 63], desired);
+    }
+    return (float)(read_cycles () - start) / BENCH_UPDATES;
+}
+
+
+/** @brief   Time the @c Q16_16 controller.
+ *  @details The inputs are converted to fixed point outside the timed loop,
+ *           as a sensor reading would arrive as an integer.
+ *  @returns The average number of cycles per update
+ */
+float time_fixed (void)
+{
+    PIDController<Q16_16> pid (3.0, 0.5, 0.05, 2.0);
+    Q16_16 desired = 0;
+    volatile int32_t fixed_input[64];
+    for (uint8_t index = 0; index < 64; index++)
+    {
+        fixed_input[index] = Q16_16 (bench_input[index]).get_raw ();
+    }
+
+    uint32_t start = read_cycles ();
+    for (uint32_t count = 0; count < BENCH_UPDATES; count++)
+    {
+        fixed_sink = pid.getCtrlOutput (
+            Q16_16::from_raw (fixed_input[count & 63]), desired).get_raw ();
+    }
+    return (float)(read_cycles () - start) / BENCH_UPDATES;
+}
+
+
+/** @brief   Find the largest difference between the two controllers' outputs.
+ *  @returns The largest absolute difference over one pass of the inputs
+ */
+float compare_outputs (void)
+{
+    PIDController<float> float_pid (3.0, 0.5, 0.05, 2.0);
+    PIDController<Q16_16> fixed_pid (3.0, 0.5, 0.05, 2.0);
+    float worst = 0;
+
+    for (uint32_t count = 0; count < 1000; count++)
+    {
+        float input = bench_input[count & 63];
+        float difference = float_pid.getCtrlOutput (input, 0.0f)
+                          - fixed_pid.getCtrlOutput (input, 0).to_float ();
+        if (fabs (difference) > worst)
+        {
+            worst = fabs (difference);
+        }
+    }
+    return worst;
+}
+
+
+/** @brief   Run the benchmark and print the results.
+ */
+void run_benchmark (void)
+{
+    make_inputs ();
+
+    // Run each once to warm the caches before timing
+    time_float ();
+    time_fixed ();
+
+    Serial.printf ("PID update, float:  %8.1f " CYCLE_UNITS "\r\n",
+                   time_float ());
+    Serial.printf ("PID update, Q16.16: %8.1f " CYCLE_UNITS "\r\n",
+                   time_fixed ());
+    Serial.printf ("Largest output difference: %.5f\r\n", compare_outputs ());
+}
+
+
+#ifdef NATIVE
+/** @brief   Run the benchmark on the PC.
+ */
+int main (void)
+{
+    run_benchmark ();
+    return 0;
+}
+#else
+/** @brief   Start the serial port, then run the benchmark.
+ */
+void setup (void)
+{
+    Serial.begin (115200);
+    delay (2000);
+}
+
+
+/** @brief   Run the benchmark every few seconds.
+ */
+void loop (void)
+{
+    run_benchmark ();
+    delay (5000);
+}
+#endif
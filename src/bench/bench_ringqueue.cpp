@@ -0,0 +1,277 @@
+/** @file    bench_ringqueue.cpp
+ *  @brief   Host check and benchmark of the lock-free @c RingQueue<T, N>.
+ *  @details This program is built by the @c native_bench_ringqueue
+ *           environment in @c platformio.ini and runs on the PC. It first
+ *           checks, in one thread, that items come out of the ring in order
+ *           when the indices wrap around the end of the buffer and past the
+ *           top of their 32-bit counts, that @c put_n() and @c get_n() move
+ *           batches which straddle the end of the buffer, and that items
+ *           which don't fit are dropped and counted as overruns. Then one
+ *           producer thread and one consumer thread pass numbered items
+ *           through a small ring in batches of changing size, and the
+ *           consumer checks that every number arrives once and in order, or
+ *           that the gaps add up to the overrun count when the producer is
+ *           not held back.
+ *
+ *           Build with @c "pio run -e native_bench_ringqueue", then run
+ *           @c .pio/build/native_bench_ringqueue/program, optionally followed
+ *           by the number of items passed in each threaded run. The program
+ *           returns 0 if every check passed and 1 if any failed.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <stdlib.h>
+#include "taskqueue.h"
+
+
+/// Capacity of the rings under test, small so that they wrap often
+const uint16_t RING_SIZE = 16;
+
+
+/** @brief   A ring whose indices can be started anywhere.
+ *  @details The indices are free-running counts, so in the firmware they
+ *           only pass the top of 32 bits after years of running. Starting
+ *           them just below it lets the wrap of the counts be checked too.
+ */
+class TestRing : public RingQueue<uint32_t, RING_SIZE>
+{
+public:
+    TestRing (const char* p_name) : RingQueue<uint32_t, RING_SIZE> (p_name, 0)
+    {
+    }
+
+    /// @brief Empty the ring and start both indices at @c start
+    void restart (uint32_t start)
+    {
+        head.store (start);
+        tail.store (start);
+        overruns = 0;
+    }
+};
+
+
+/// Number of checks which failed
+uint32_t failures = 0;
+
+
+/** @brief   Print the result of one check and count it if it failed.
+ *  @param   passed Whether the check passed
+ *  @param   what A description of the check
+ */
+void check (bool passed, const char* what)
+{
+    Serial.printf ("  %-52s %s\r\n", what, passed ? "pass" : "FAIL");
+    if (!passed)
+    {
+        failures++;
+    }
+}
+
+
+/** @brief   Pass numbered items through the ring in batches, in one thread.
+ *  @details Batches of 1 to 11 items, which don't divide the ring's size,
+ *           are put in and taken out, so the batches start at every place in
+ *           the buffer and many of them straddle its end. Each batch taken
+ *           out asks for one more item than the batch just put in, except
+ *           after the largest, so the ring fills to 10 items at most and
+ *           nothing should be dropped.
+ *  @param   ring The ring to be exercised
+ *  @param   start The value at which both indices start
+ *  @returns @c true if every item came out in order
+ */
+bool check_batches (TestRing& ring, uint32_t start)
+{
+    ring.restart (start);
+
+    uint32_t sent = 0;
+    uint32_t expected = 0;
+    uint32_t items[RING_SIZE];
+    for (uint32_t round = 0; round < 1000; round++)
+    {
+        uint16_t batch = 1 + round % 11;
+        for (uint16_t index = 0; index < batch; index++)
+        {
+            items[index] = sent + index;
+        }
+        sent += ring.put_n (items, batch);
+
+        uint16_t got = ring.get_n (items, 1 + (round + 1) % 11);
+        for (uint16_t index = 0; index < got; index++)
+        {
+            if (items[index] != expected++)
+            {
+                return false;
+            }
+        }
+    }
+
+    // Empty the ring and see that nothing was lost or dropped
+    uint16_t got;
+    while ((got = ring.get_n (items, RING_SIZE)) > 0)
+    {
+        for (uint16_t index = 0; index < got; index++)
+        {
+            if (items[index] != expected++)
+            {
+                return false;
+            }
+        }
+    }
+    return expected == sent && ring.get_overruns () == 0;
+}
+
+
+/** @brief   Check that items which don't fit are dropped and counted.
+ *  @param   ring The ring to be exercised
+ */
+void check_overruns (TestRing& ring)
+{
+    ring.restart (5);
+
+    uint32_t items[RING_SIZE + 4];
+    for (uint16_t index = 0; index < RING_SIZE + 4; index++)
+    {
+        items[index] = index;
+    }
+
+    // Fill the ring most of the way, then try to put in more than fits
+    uint16_t put = ring.put_n (items, RING_SIZE - 3);
+    put += ring.put_n (items + put, 7);
+    check (put == RING_SIZE && ring.get_overruns () == 4,
+           "put_n() keeps what fits and counts the rest");
+
+    check (!ring.put (99) && ring.get_overruns () == 5,
+           "put() into a full ring fails and counts an overrun");
+
+    bool in_order = true;
+    for (uint16_t index = 0; index < RING_SIZE; index++)
+    {
+        in_order &= ring.get () == index;
+    }
+    check (in_order && ring.is_empty (),
+           "Items kept when full come out in order");
+
+    uint32_t item = 12345;
+    ring.get (item);
+    check (item == 12345, "get() from an empty ring leaves the item alone");
+}
+
+
+/** @brief   Pass items from a producer thread to a consumer thread.
+ *  @param   ring The ring to be exercised
+ *  @param   total The number of items the producer sends
+ *  @param   retry If @c true, the producer puts in again whatever didn't fit,
+ *           so nothing is lost; if @c false, items which don't fit are
+ *           dropped
+ *  @param   overruns Set to the number of items the ring turned away
+ *  @param   skipped Set to the number of items the consumer never saw
+ *  @returns @c true if the items which arrived came in increasing order
+ */
+bool run_threads (TestRing& ring, uint32_t total, bool retry,
+                  uint32_t& overruns, uint32_t& skipped)
+{
+    ring.restart (0xFFFFFFFF - 1000);
+    std::atomic<bool> done (false);
+
+    std::thread producer ([&]
+    {
+        uint32_t items[11];
+        uint32_t sent = 0;
+        uint32_t round = 0;
+        while (sent < total)
+        {
+            uint16_t batch = 1 + round++ % 11;
+            if (batch > total - sent)
+            {
+                batch = total - sent;
+            }
+            for (uint16_t index = 0; index < batch; index++)
+            {
+                items[index] = sent + index;
+            }
+            uint16_t put = ring.put_n (items, batch);
+            sent += retry ? put : batch;
+            if (put < batch)
+            {
+                std::this_thread::yield ();
+            }
+        }
+        done = true;
+    });
+
+    bool in_order = true;
+    uint32_t next = 0;
+    uint32_t missing = 0;
+    uint32_t items[RING_SIZE];
+    uint32_t round = 0;
+    while (!done.load () || ring.any ())
+    {
+        uint16_t got = ring.get_n (items, 1 + (round++ * 5) % RING_SIZE);
+        for (uint16_t index = 0; index < got; index++)
+        {
+            if (items[index] < next)
+            {
+                in_order = false;
+            }
+            else
+            {
+                missing += items[index] - next;
+                next = items[index] + 1;
+            }
+        }
+    }
+    producer.join ();
+
+    overruns = ring.get_overruns ();
+    skipped = missing + (total - next);
+    return in_order;
+}
+
+
+/** @brief   Run the checks and time the threaded runs.
+ *  @param   argc The number of command line arguments
+ *  @param   argv The arguments; the first, if given, is the number of items
+ *           passed in each threaded run
+ *  @returns 0 if every check passed, 1 if any failed
+ */
+int main (int argc, char** argv)
+{
+    uint32_t total = (argc > 1) ? (uint32_t)atol (argv[1]) : 2000000;
+    TestRing ring ("Test ring");
+
+    Serial << "RingQueue check, " << RING_SIZE << " items" << endl;
+    check (check_batches (ring, 0),
+           "Batches in order as the buffer wraps");
+    check (check_batches (ring, 0xFFFFFFFF - 100),
+           "Batches in order as the 32-bit counts wrap");
+    check_overruns (ring);
+
+    Serial << endl << "Producer and consumer threads, " << total << " items"
+           << endl;
+    uint32_t overruns, skipped;
+
+    auto start = std::chrono::steady_clock::now ();
+    bool in_order = run_threads (ring, total, true, overruns, skipped);
+    double seconds = std::chrono::duration<double> (
+        std::chrono::steady_clock::now () - start).count ();
+    check (in_order && skipped == 0,
+           "Producer which puts again what didn't fit: none lost");
+    Serial.printf ("    %.1f million items/s\r\n", total / seconds / 1e6);
+
+    in_order = run_threads (ring, total, false, overruns, skipped);
+    check (in_order && skipped == overruns,
+           "Producer which never waits: gaps equal overruns");
+    Serial.printf ("    %u items dropped\r\n", (unsigned)overruns);
+
+    Serial << endl;
+    print_all_shares (Serial);
+
+    Serial << endl << (failures ? "FAILED" : "All checks passed") << endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,200 @@
+/** @file    bench_shares.cpp
+ *  @brief   Host benchmark comparing @c SeqShare<T> with queue-backed
+ *           @c Share<T>.
+ *  @details This program is built by the @c native_bench_shares environment
+ *           in @c platformio.ini and runs on the PC, where real threads on
+ *           several cores can hammer a share far harder than the tasks on the
+ *           ESP32 ever will. It measures the cost of one @c put() and one
+ *           @c get() with no contention, then runs one writer against an
+ *           increasing number of reader threads and counts reads, writes and
+ *           torn reads (items whose fields came from different writes).
+ *
+ *           Build with @c "pio run -e native_bench_shares", then run
+ *           @c .pio/build/native_bench_shares/program, optionally followed by
+ *           the number of milliseconds for which each contended test runs.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <stdlib.h>
+#include "taskshare.h"
+#include "seqshare.h"
+
+
+/// @brief A multi-field item like an attitude sample; every field is the same
+struct BenchItem
+{
+    float field[8];                     ///< Each field holds the write count
+
+    void fill (uint32_t count)
+    {
+        for (uint8_t index = 0; index < 8; index++)
+        {
+            field[index] = (float)count;
+        }
+    }
+
+    bool torn (void) const
+    {
+        for (uint8_t index = 1; index < 8; index++)
+        {
+            if (field[index] != field[0])
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+
+/// Shares under test; they register in the share list like any others
+Share<BenchItem> queue_share ("Queue share");
+SeqShare<BenchItem> seq_share ("Seq share");
+
+
+/** @brief   Time one call of @c put() followed by @c get(), uncontended.
+ *  @param   share The share to be exercised
+ *  @param   iterations How many put/get pairs to time
+ *  @returns The average time for one pair in nanoseconds
+ */
+template <class ShareType>
+double time_uncontended (ShareType& share, uint32_t iterations)
+{
+    BenchItem item;
+    item.fill (0);
+    share.put (item);
+
+    auto start = std::chrono::steady_clock::now ();
+    for (uint32_t count = 1; count <= iterations; count++)
+    {
+        item.fill (count);
+        share.put (item);
+        share.get (item);
+    }
+    auto stop = std::chrono::steady_clock::now ();
+
+    return std::chrono::duration<double, std::nano> (stop - start).count ()
+           / iterations;
+}
+
+
+/** @brief   Run one writer and several readers against a share at once.
+ *  @param   share The share to be exercised
+ *  @param   readers The number of reader threads
+ *  @param   run_ms How long to run, in milliseconds
+ *  @param   reads Set to the total number of reads made by all readers
+ *  @param   writes Set to the number of writes made by the writer
+ *  @param   torn Set to the number of reads which returned mixed data
+ */
+template <class ShareType>
+void run_contended (ShareType& share, uint16_t readers, uint32_t run_ms,
+                    uint64_t& reads, uint64_t& writes, uint64_t& torn)
+{
+    std::atomic<bool> running (true);
+    std::atomic<uint64_t> total_reads (0);
+    std::atomic<uint64_t> total_torn (0);
+    uint64_t write_count = 0;
+
+    std::thread writer ([&]
+    {
+        BenchItem item;
+        while (running.load (std::memory_order_relaxed))
+        {
+            item.fill ((uint32_t)++write_count);
+            share.put (item);
+        }
+    });
+
+    std::vector<std::thread> reader_threads;
+    for (uint16_t index = 0; index < readers; index++)
+    {
+        reader_threads.emplace_back ([&]
+        {
+            BenchItem item;
+            uint64_t my_reads = 0;
+            uint64_t my_torn = 0;
+            while (running.load (std::memory_order_relaxed))
+            {
+                share.get (item);
+                my_reads++;
+                my_torn += item.torn ();
+            }
+            total_reads += my_reads;
+            total_torn += my_torn;
+        });
+    }
+
+    delay (run_ms);
+    running = false;
+    writer.join ();
+    for (std::thread& reader : reader_threads)
+    {
+        reader.join ();
+    }
+
+    reads = total_reads;
+    writes = write_count;
+    torn = total_torn;
+}
+
+
+/** @brief   Print one line of contended results for one share type.
+ *  @param   label The name of the share type
+ *  @param   share The share to be exercised
+ *  @param   readers The number of reader threads
+ *  @param   run_ms How long to run, in milliseconds
+ */
+template <class ShareType>
+void report_contended (const char* label, ShareType& share, uint16_t readers,
+                       uint32_t run_ms)
+{
+    uint64_t reads, writes, torn;
+    run_contended (share, readers, run_ms, reads, writes, torn);
+
+    double seconds = run_ms / 1000.0;
+    Serial.printf ("%-10s %7u %14.0f %14.0f %10llu\r\n", label,
+                   (unsigned)readers, reads / seconds, writes / seconds,
+                   (unsigned long long)torn);
+}
+
+
+/** @brief   Run the benchmark.
+ *  @param   argc The number of command line arguments
+ *  @param   argv The arguments; the first, if given, is the run time in ms
+ */
+int main (int argc, char** argv)
+{
+    uint32_t run_ms = (argc > 1) ? (uint32_t)atol (argv[1]) : 500;
+    uint16_t max_readers = std::thread::hardware_concurrency ();
+    max_readers = (max_readers > 1) ? max_readers - 1 : 1;
+
+    Serial << "Share benchmark, " << sizeof (BenchItem) << " byte items"
+           << endl << endl;
+
+    const uint32_t iterations = 1000000;
+    Serial.printf ("Uncontended put+get:   Share %8.1f ns   SeqShare %8.1f ns\r\n",
+                   time_uncontended (queue_share, iterations),
+                   time_uncontended (seq_share, iterations));
+
+    Serial << endl << "Contended, one writer, " << run_ms << " ms per run"
+           << endl;
+    Serial.printf ("%-10s %7s %14s %14s %10s\r\n", "Type", "Readers",
+                   "Reads/s", "Writes/s", "Torn");
+    for (uint16_t readers = 1; readers <= max_readers; readers *= 2)
+    {
+        report_contended ("Share", queue_share, readers, run_ms);
+        report_contended ("SeqShare", seq_share, readers, run_ms);
+    }
+
+    Serial << endl;
+    print_all_shares (Serial);
+
+    return 0;
+}
@@ -0,0 +1,40 @@
+/** @file    benchcycles.h
+ *  @brief   A cycle counter for the benchmarks, on the PC or the ESP32.
+ *  @details On x86 PCs cycles are counted with the time stamp counter. On
+ *           other PCs, which have no cycle counter that a program may read,
+ *           nanoseconds are counted instead. On the ESP32 cycles are the
+ *           CPU's cycle count. @c CYCLE_UNITS names whichever is counted, for
+ *           printing beside the results.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file, from the copies in the benchmarks
+ */
+
+#ifndef _BENCHCYCLES_H_
+#define _BENCHCYCLES_H_
+
+#include <Arduino.h>
+
+#ifdef NATIVE
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+/// Read the CPU's time stamp counter
+static inline uint32_t read_cycles (void) { return (uint32_t)__rdtsc (); }
+#define CYCLE_UNITS "cycles"
+#else
+#include <chrono>
+/// Read a nanosecond clock where there's no cycle counter to read
+static inline uint32_t read_cycles (void)
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds> (
+        std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+#define CYCLE_UNITS "ns"
+#endif
+#else
+/// Read the CPU's cycle count
+static inline uint32_t read_cycles (void) { return ESP.getCycleCount (); }
+#define CYCLE_UNITS "cycles"
+#endif
+
+#endif // _BENCHCYCLES_H_
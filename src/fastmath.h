@@ -0,0 +1,178 @@
+/** @file    fastmath.h
+ *  @brief   Quick single-precision versions of the math functions used each
+ *           time the IMU is read and the controllers run.
+ *  @details The ESP32's floating point unit adds and multiplies in single
+ *           precision in a cycle or so, but anything written with a
+ *           @c double, such as @c 180/M_PI, is done in software, and the
+ *           library's @c atan2(), @c sin() and @c cos() are long routines.
+ *           The functions here work in @c float with polynomials, and are
+ *           inline so they cost no calls. @c fast_atan2() needs one division
+ *           to bring its argument between 0 and 1; the others only add and
+ *           multiply.
+ *
+ *           The square roots may be found either by the library or from a
+ *           bit trick and two Newton steps, chosen by @c FAST_MATH_ROOTS.
+ *           On the PC the library's @c sqrtf() is quicker, as the CPU has a
+ *           square root instruction. Run @c src/bench/bench_fastmath.cpp on
+ *           the ESP32 and set @c FAST_MATH_ROOTS only if it shows the bit
+ *           trick to be quicker there too.
+ *
+ *           The largest errors, measured against the library in double
+ *           precision by @c src/bench/bench_fastmath.cpp, are:
+ *
+ *           | Function            | Inputs              | Largest error     |
+ *           |---------------------|---------------------|-------------------|
+ *           | @c bit_inv_sqrt()   | 1e-30 to 1e30       | 4.8e-6 relative   |
+ *           | @c bit_sqrt()       | 1e-30 to 1e30       | 4.8e-6 relative   |
+ *           | @c fast_atan2()     | any but (0, 0)      | 1.2e-5 rad        |
+ *           | @c fast_sincos()    | -100 to 100 rad     | 4e-7              |
+ *
+ *           The largest, 0.0007 degrees, is far inside the noise of the IMU.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Bit-trick square roots only used if @c FAST_MATH_ROOTS
+ */
+
+#ifndef _FASTMATH_H_
+#define _FASTMATH_H_
+
+#include <Arduino.h>
+#include <string.h>
+
+
+// Whether fast_inv_sqrt() and fast_sqrt() use the bit trick rather than the
+// library. This may be changed with -D options in the build_flags of
+// platformio.ini
+#ifndef FAST_MATH_ROOTS
+#define FAST_MATH_ROOTS false       ///< Use the library's sqrtf() until timed on the ESP32
+#endif
+
+/// Degrees in a radian, as a @c float so that converting costs one multiply
+const float DEG_PER_RAD = 57.2957795f;
+
+/// Radians in a degree
+const float RAD_PER_DEG = 0.0174532925f;
+
+
+/** @brief   Find one over the square root of a number with a bit trick.
+ *  @details A guess taken from the bits of the number's exponent is improved
+ *           by two steps of Newton's method, each of which roughly squares
+ *           the relative error.
+ *  @param   x A positive number
+ *  @returns One over the square root of @c x
+ */
+inline float bit_inv_sqrt (float x)
+{
+    uint32_t bits;
+    memcpy (&bits, &x, sizeof (bits));
+    bits = 0x5F375A86 - (bits >> 1);
+    float y;
+    memcpy (&y, &bits, sizeof (y));
+
+    float half_x = 0.5f * x;
+    y = y * (1.5f - half_x * y * y);
+    y = y * (1.5f - half_x * y * y);
+    return y;
+}
+
+
+/** @brief   Find the square root of a number with a bit trick.
+ *  @param   x A number, of which zero or less gives zero
+ *  @returns The square root of @c x
+ */
+inline float bit_sqrt (float x)
+{
+    return (x > 0) ? x * bit_inv_sqrt (x) : 0.0f;
+}
+
+
+/** @brief   Find one over the square root of a number in the quicker way.
+ *  @param   x A positive number
+ *  @returns One over the square root of @c x
+ */
+inline float fast_inv_sqrt (float x)
+{
+    return FAST_MATH_ROOTS ? bit_inv_sqrt (x) : 1.0f / sqrtf (x);
+}
+
+
+/** @brief   Find the square root of a number in the quicker way.
+ *  @param   x A number, of which zero or less gives zero
+ *  @returns The square root of @c x
+ */
+inline float fast_sqrt (float x)
+{
+    if (FAST_MATH_ROOTS)
+    {
+        return bit_sqrt (x);
+    }
+    return (x > 0) ? sqrtf (x) : 0.0f;
+}
+
+
+/** @brief   Find the angle of the point (x, y) from the x axis.
+ *  @details The angle is found from the arctangent of the smaller of
+ *           |y|/|x| and |x|/|y|, which lies between 0 and 1, by a polynomial
+ *           in its square (Abramowitz and Stegun 4.4.49), then moved into the
+ *           right octant.
+ *  @param   y The y coordinate
+ *  @param   x The x coordinate
+ *  @returns The angle, from -pi to pi (rad), or 0 if both are 0
+ */
+inline float fast_atan2 (float y, float x)
+{
+    float abs_x = fabsf (x);
+    float abs_y = fabsf (y);
+    if (abs_x == 0 && abs_y == 0)
+    {
+        return 0;
+    }
+    bool steep = abs_y > abs_x;
+    float z = steep ? abs_x / abs_y : abs_y / abs_x;
+    float z2 = z * z;
+    float angle = z * (0.9998660f + z2 * (-0.3302995f + z2 * (0.1801410f
+                  + z2 * (-0.0851330f + z2 * 0.0208351f))));
+    if (steep)
+    {
+        angle = 1.57079633f - angle;
+    }
+    if (x < 0)
+    {
+        angle = 3.14159265f - angle;
+    }
+    return (y < 0) ? -angle : angle;
+}
+
+
+/** @brief   Find the sine and cosine of an angle together.
+ *  @details The angle is brought to within pi/4 of a multiple of pi/2, in
+ *           two parts so that little precision is lost, and both results are
+ *           found from the same remainder with short polynomials. The
+ *           quarter turns are then used to swap and negate them.
+ *  @param   angle The angle (rad)
+ *  @param   sine Set to the sine of the angle
+ *  @param   cosine Set to the cosine of the angle
+ */
+inline void fast_sincos (float angle, float& sine, float& cosine)
+{
+    float turns = angle * 0.636619772f;
+    int32_t quarter = (int32_t)(turns + ((turns < 0) ? -0.5f : 0.5f));
+    float r = (angle - quarter * 1.5703125f) - quarter * 4.83826795e-4f;
+    float r2 = r * r;
+
+    float s = r * (1 + r2 * (-1.66666672e-1f + r2 * (8.33333377e-3f
+              + r2 * -1.98412701e-4f)));
+    float c = 1 + r2 * (-0.5f + r2 * (4.16666679e-2f + r2 * (-1.38888892e-3f
+              + r2 * 2.48015876e-5f)));
+
+    // Odd quarter turns swap the two; the second and third negate the sine
+    // and the first and second the cosine
+    bool odd = quarter & 1;
+    float sign_s = (quarter & 2) ? -1.0f : 1.0f;
+    float sign_c = ((quarter + 1) & 2) ? -1.0f : 1.0f;
+    sine = sign_s * (odd ? c : s);
+    cosine = sign_c * (odd ? s : c);
+}
+
+#endif // _FASTMATH_H_
@@ -0,0 +1,178 @@
+/** @file    fixedpoint.h
+ *  @brief   A saturating fixed-point number type in a configurable Q format.
+ *  @details A @c Fixed<16> is a Q16.16 number: a 32-bit signed integer of
+ *           which the low 16 bits are the fraction, giving a range of about
+ *           +/-32768 in steps of 1/65536. Arithmetic uses only the integer
+ *           unit, so it needs no FPU state, and results which don't fit are
+ *           clamped to the largest or smallest value rather than wrapping
+ *           around to the other sign.
+ *
+ *           Neither its speed nor its use in an ISR has been tested on the
+ *           ESP32. On the PC, @c src/bench/bench_pid.cpp finds a Q16.16 PID
+ *           update four or five times as slow as a @c float one, so run that
+ *           benchmark on the board before choosing fixed point for speed.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Conversion from @c float saturates NaN and infinities
+ */
+
+#ifndef _FIXEDPOINT_H_
+#define _FIXEDPOINT_H_
+
+#include <Arduino.h>
+
+
+/** @brief   Class for a signed fixed-point number with @c frac_bits bits of
+ *           fraction in a 32-bit integer.
+ *  @details Numbers are converted from @c float or @c int implicitly, so
+ *           constants may be written as usual; converting back to @c float
+ *           takes an explicit call to @c to_float(). Conversions from @c float
+ *           are meant for setting things up, not for inner loops.
+ *
+ *           @section usage_fixed Usage
+ *           @code{.cpp}
+ *           Q16_16 gain = 2.5;
+ *           Q16_16 error = Q16_16 (10) - reading;
+ *           Q16_16 output = gain * error;
+ *           Serial << output.to_float () << endl;
+ *           @endcode
+ */
+template <uint8_t frac_bits>
+class Fixed
+{
+    static_assert (frac_bits > 0 && frac_bits < 31,
+                   "A Fixed needs between 1 and 30 fraction bits");
+
+protected:
+    int32_t raw;                        ///< The value times 2^frac_bits
+
+    /** @brief   Clamp a 64-bit intermediate result into 32 bits.
+     *  @param   value The result of a calculation
+     *  @returns The closest value which fits in an @c int32_t
+     */
+    static int32_t saturate (int64_t value)
+    {
+        if (value > INT32_MAX)
+        {
+            return INT32_MAX;
+        }
+        if (value < INT32_MIN)
+        {
+            return INT32_MIN;
+        }
+        return (int32_t)value;
+    }
+
+    /** @brief   Convert a @c float to a raw value, rounding to the nearest
+     *           step.
+     *  @details The range is checked in @c float before the cast, as casting
+     *           a NaN, an infinity or a value too big for the integer is
+     *           undefined. Values out of range saturate, and NaN becomes 0.
+     *  @param   value The number to be converted
+     *  @returns The raw value which represents @c value
+     */
+    static int32_t raw_from_float (float value)
+    {
+        float scaled = value * ONE;
+        if (scaled != scaled)
+        {
+            return 0;
+        }
+        if (scaled >= 2147483648.0f)
+        {
+            return INT32_MAX;
+        }
+        if (scaled <= -2147483648.0f)
+        {
+            return INT32_MIN;
+        }
+        return (int32_t)(scaled + (scaled < 0 ? -0.5f : 0.5f));
+    }
+
+public:
+    /// The raw value which represents 1.0
+    static const int32_t ONE = (int32_t)1 << frac_bits;
+
+    /// Create a number equal to zero
+    Fixed (void) : raw (0) { }
+
+    /// Create a number from a @c float, rounding to the nearest step
+    Fixed (float value) : raw (raw_from_float (value)) { }
+
+    /// Create a number from a @c double, rounding to the nearest step
+    Fixed (double value) : Fixed ((float)value) { }
+
+    /// Create a number from an integer
+    Fixed (int value) : raw (saturate ((int64_t)value * ONE)) { }
+
+    /** @brief   Create a number from its raw integer representation.
+     *  @param   a_raw The value times 2^frac_bits
+     *  @returns The fixed-point number
+     */
+    static Fixed from_raw (int32_t a_raw)
+    {
+        Fixed result;
+        result.raw = a_raw;
+        return result;
+    }
+
+    /// Return the raw integer representation, the value times 2^frac_bits
+    int32_t get_raw (void) const { return raw; }
+
+    /// Return the value as a @c float
+    float to_float (void) const { return (float)raw / ONE; }
+
+    /// Add two numbers, saturating
+    Fixed operator + (Fixed other) const
+    {
+        return from_raw (saturate ((int64_t)raw + other.raw));
+    }
+
+    /// Subtract two numbers, saturating
+    Fixed operator - (Fixed other) const
+    {
+        return from_raw (saturate ((int64_t)raw - other.raw));
+    }
+
+    /// Negate a number; the most negative value becomes the most positive
+    Fixed operator - (void) const
+    {
+        return from_raw (saturate (-(int64_t)raw));
+    }
+
+    /// Multiply two numbers, saturating; the result is rounded toward -inf
+    Fixed operator * (Fixed other) const
+    {
+        return from_raw (saturate (((int64_t)raw * other.raw) >> frac_bits));
+    }
+
+    /// Divide two numbers, saturating; dividing by zero gives the largest
+    /// value with the sign of the dividend
+    Fixed operator / (Fixed other) const
+    {
+        if (other.raw == 0)
+        {
+            return from_raw (raw < 0 ? INT32_MIN : INT32_MAX);
+        }
+        return from_raw (saturate (((int64_t)raw * ONE) / other.raw));
+    }
+
+    Fixed& operator += (Fixed other) { return *this = *this + other; }
+    Fixed& operator -= (Fixed other) { return *this = *this - other; }
+    Fixed& operator *= (Fixed other) { return *this = *this * other; }
+    Fixed& operator /= (Fixed other) { return *this = *this / other; }
+
+    bool operator == (Fixed other) const { return raw == other.raw; }
+    bool operator != (Fixed other) const { return raw != other.raw; }
+    bool operator < (Fixed other) const { return raw < other.raw; }
+    bool operator > (Fixed other) const { return raw > other.raw; }
+    bool operator <= (Fixed other) const { return raw <= other.raw; }
+    bool operator >= (Fixed other) const { return raw >= other.raw; }
+};
+
+
+/// Q16.16 fixed point: range about +/-32768, resolution about 0.000015
+typedef Fixed<16> Q16_16;
+
+#endif // _FIXEDPOINT_H_
@@ -0,0 +1,148 @@
+/** @file    flare.cpp
+ *  @brief   Source code for the smooth attitude setpoints used in the cruise
+ *           and the flare before touchdown.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Uses the quick functions in fastmath.h
+ */
+
+#include "flare.h"
+#include "fastmath.h"
+
+
+/** @brief   Create a generator with the given limits.
+ *  @param   a_max_rate The fastest the setpoint may change (deg/s)
+ *  @param   a_max_accel The greatest acceleration of the setpoint (deg/s^2)
+ */
+SetpointGenerator::SetpointGenerator (float a_max_rate, float a_max_accel)
+    : max_rate (a_max_rate), max_accel (a_max_accel)
+{
+    position = 0;
+    velocity = 0;
+    last_us = 0;
+    started = false;
+}
+
+
+/** @brief   Move the setpoint toward a target.
+ *  @details The time step is measured from the times given. After a reset
+ *           the setpoint starts at rest from @c start, normally the measured
+ *           angle, so that taking control doesn't cause a jump either.
+ *  @param   target The angle wanted (deg)
+ *  @param   start The angle from which to start after a reset (deg)
+ *  @param   time_us The present time, such as an IMU sample's time (us)
+ *  @returns The new setpoint (deg)
+ */
+float SetpointGenerator::update (float target, float start, uint32_t time_us)
+{
+    if (!started)
+    {
+        position = start;
+        velocity = 0;
+        last_us = time_us;
+        started = true;
+        return position;
+    }
+    float dt = (time_us - last_us) * 1e-6f;
+    last_us = time_us;
+
+    // The fastest speed from which the setpoint can stop at the target
+    float error = target - position;
+    float stop_speed = fast_sqrt (2 * max_accel * fabsf (error));
+    float wanted = (stop_speed < max_rate) ? stop_speed : max_rate;
+    if (error < 0)
+    {
+        wanted = -wanted;
+    }
+
+    // Change speed toward that by no more than the acceleration allows
+    float max_change = max_accel * dt;
+    float change = wanted - velocity;
+    if (change > max_change)
+    {
+        change = max_change;
+    }
+    else if (change < -max_change)
+    {
+        change = -max_change;
+    }
+    velocity += change;
+    position += velocity * dt;
+
+    // Steps of finite length can carry the setpoint just past the target.
+    // If it could have stopped there within one step, stop it there
+    if ((target - position) * error <= 0 && fabsf (velocity) <= max_change)
+    {
+        position = target;
+        velocity = 0;
+    }
+    return position;
+}
+
+
+/** @brief   Create an estimator which has had no readings.
+ */
+DescentEstimator::DescentEstimator (void)
+{
+    last_height = 0;
+    last_ms = 0;
+    rate = 0;
+    started = false;
+}
+
+
+/** @brief   Add a height reading and return the rate of descent.
+ *  @param   height The height from the ultrasonic sensor (cm)
+ *  @param   time_ms The time of the reading (ms)
+ *  @returns The filtered rate of descent, positive downward (cm/s)
+ */
+float DescentEstimator::update (float height, uint32_t time_ms)
+{
+    if (started && time_ms != last_ms)
+    {
+        float dt = time_ms - last_ms;
+        float raw = (last_height - height) * 1000 / dt;
+        rate += (raw - rate) * dt / (DESCENT_FILTER_TIME + dt);
+    }
+    last_height = height;
+    last_ms = time_ms;
+    started = true;
+    return rate;
+}
+
+
+/** @brief   Return the pitch wanted at a given height and rate of descent.
+ *  @details The flare starts at @c FLARE_HEIGHT, or earlier if the glider is
+ *           coming down fast enough to reach the ground within
+ *           @c FLARE_TIME, and the pitch wanted rises in proportion from
+ *           zero to @c FLARE_PITCH at the ground. The @c SetpointGenerator
+ *           which follows this target keeps the rise smooth.
+ *  @param   height The height from the ultrasonic sensor (cm)
+ *  @param   descent_rate The rate of descent, positive downward (cm/s)
+ *  @returns The pitch wanted (deg)
+ */
+float flare_pitch (float height, float descent_rate)
+{
+    if (!isfinite (height))
+    {
+        return 0;
+    }
+
+    // How far through the flare the glider is, by height and by time
+    float fraction = 1 - height / FLARE_HEIGHT;
+    if (descent_rate > 0 && isfinite (descent_rate))
+    {
+        float by_time = 1 - height * 1000 / (descent_rate * FLARE_TIME);
+        if (by_time > fraction)
+        {
+            fraction = by_time;
+        }
+    }
+
+    if (fraction <= 0)
+    {
+        return 0;
+    }
+    return (fraction < 1) ? fraction * FLARE_PITCH : FLARE_PITCH;
+}
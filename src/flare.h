@@ -0,0 +1,105 @@
+/** @file    flare.h
+ *  @brief   Headers for the smooth attitude setpoints used in the cruise and
+ *           the flare before touchdown.
+ *  @details Rather than jumping from level flight to @c FLARE_PITCH when the
+ *           glider nears the ground, the pitch wanted is raised gradually as
+ *           the ground comes closer. A @c FlareProfile turns the height and
+ *           rate of descent from the ultrasonic sensor into a target pitch,
+ *           and a @c SetpointGenerator follows each target with a setpoint
+ *           whose rate and acceleration are limited, so the attitude loops
+ *           never see a step and the surface motors never slam.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#ifndef _FLARE_H_
+#define _FLARE_H_
+
+#include <Arduino.h>
+
+
+/// Pitch held at touchdown, at the end of the flare (deg)
+#define FLARE_PITCH 10
+
+/// Height below which the flare begins at the latest (cm)
+#define FLARE_HEIGHT 100
+
+/// Time before touchdown at which the flare begins if descending fast (ms)
+#define FLARE_TIME 1000
+
+/// Fastest change of an attitude setpoint (deg/s)
+#define SETPOINT_RATE 20
+
+/// Greatest acceleration of an attitude setpoint (deg/s^2)
+#define SETPOINT_ACCEL 60
+
+/// Time constant of the filter on the rate of descent (ms)
+#define DESCENT_FILTER_TIME 300
+
+
+/** @brief   Class which follows a target angle with a rate and acceleration
+ *           limited setpoint.
+ *  @details Each update the setpoint speeds up toward the target as fast as
+ *           the acceleration limit allows, up to the rate limit, but no
+ *           faster than the speed from which it can still stop at the target
+ *           without overshooting. The result is a smooth S-shaped move which
+ *           ends at the target. If the target moves, the setpoint follows
+ *           from wherever it is, at whatever speed it has.
+ */
+class SetpointGenerator
+{
+protected:
+    float max_rate;                     ///< Rate limit (deg/s)
+    float max_accel;                    ///< Acceleration limit (deg/s^2)
+    float position;                     ///< Present setpoint (deg)
+    float velocity;                     ///< Rate of change of the setpoint (deg/s)
+    uint32_t last_us;                   ///< Time of the last update (us)
+    bool started;                       ///< Whether updated since the last reset
+
+public:
+    // Create a generator with the given limits
+    SetpointGenerator (float a_max_rate = SETPOINT_RATE,
+                       float a_max_accel = SETPOINT_ACCEL);
+
+    /// Start again from the given angle at the next update
+    void reset (void) { started = false; }
+
+    // Move the setpoint toward a target
+    float update (float target, float start, uint32_t time_us);
+
+    /// Return the present setpoint
+    float get_setpoint (void) const { return position; }
+};
+
+
+/** @brief   Class which estimates the rate of descent from ultrasonic
+ *           heights.
+ *  @details The heights are differentiated and the result smoothed with a
+ *           first order filter, since the sensor's noise is large compared
+ *           with the change in height between readings.
+ */
+class DescentEstimator
+{
+protected:
+    float last_height;                  ///< Height at the last reading (cm)
+    uint32_t last_ms;                   ///< Time of the last reading (ms)
+    float rate;                         ///< Filtered rate of descent (cm/s)
+    bool started;                       ///< Whether there has been a reading
+
+public:
+    // Create an estimator which has had no readings
+    DescentEstimator (void);
+
+    // Add a height reading and return the rate of descent
+    float update (float height, uint32_t time_ms);
+
+    /// Return the rate of descent, positive downward (cm/s)
+    float get_rate (void) const { return rate; }
+};
+
+
+// Return the pitch wanted at a given height and rate of descent
+float flare_pitch (float height, float descent_rate);
+
+#endif // _FLARE_H_
@@ -0,0 +1,441 @@
+/** @file    flightcontrol.cpp
+ *  @brief   Source code for the attitude controller's state machine.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file, from the loop in @c task_controller
+ *  @date   2026-Oct-16 State machine driven by constant tables; transition log
+ *  @date   2026-Oct-16 Smooth attitude setpoints; flare by height and descent rate
+ */
+
+#include "flightcontrol.h"
+
+
+/** @brief   The state and transition tables.
+ *  @details In state 0 the controller waits with the motors off until it is
+ *           moved to another state from outside. In state 1 it waits until
+ *           the glider has been off the ground for @c LAUNCH_DELAY, then goes
+ *           to state 2. In state 2 it holds the wings level and the pitch at
+ *           zero, raising the pitch smoothly to @c FLARE_PITCH as the ground
+ *           comes near, until the glider has been near the ground for
+ *           @c LANDED_DELAY, then goes to state 0.
+ *           In state 3 it asks the surface loop to autotune itself and goes
+ *           to state 0 when that has finished. The transitions are checked in
+ *           the order listed and the first whose guard is true is taken.
+ */
+struct FlightController::Table
+{
+    /// What each state does, in the order of @c ControllerState
+    static constexpr StateInfo states[STATE_COUNT] =
+    {
+        {STATE_DISABLED, "disabled", &FlightController::enter_disabled,
+         &FlightController::hold_idle, nullptr},
+        {STATE_WAIT_FOR_LAUNCH, "wait_for_launch", &FlightController::enter_waiting,
+         &FlightController::wait_for_launch, nullptr},
+        {STATE_ACTIVE, "active", &FlightController::enter_active,
+         &FlightController::control_attitude, &FlightController::stop_surfaces},
+        {STATE_AUTOTUNE, "autotune", &FlightController::enter_autotune,
+         &FlightController::hold_idle, &FlightController::stop_surfaces}
+    };
+
+    /// The transitions which the controller makes by itself
+    static constexpr TransitionRule rules[] =
+    {
+        {STATE_WAIT_FOR_LAUNCH, STATE_ACTIVE, &FlightController::launched, "launched"},
+        {STATE_ACTIVE, STATE_DISABLED, &FlightController::landed, "landed"},
+        {STATE_AUTOTUNE, STATE_DISABLED, &FlightController::tuned, "tuned"}
+    };
+
+    /// Number of transitions in @c rules
+    static constexpr uint8_t RULE_COUNT = sizeof (rules) / sizeof (rules[0]);
+
+    /// Check that each row of the state table is for the state of its index
+    static constexpr bool states_in_order (uint8_t index)
+    {
+        return index >= STATE_COUNT
+               || (states[index].state == index && states[index].during != nullptr
+                   && states_in_order (index + 1));
+    }
+
+    /// Check that each transition joins two different states and has a guard
+    static constexpr bool rules_valid (uint8_t index)
+    {
+        return index >= RULE_COUNT
+               || (rules[index].from < STATE_COUNT && rules[index].to < STATE_COUNT
+                   && rules[index].from != rules[index].to
+                   && rules[index].guard != nullptr && rules_valid (index + 1));
+    }
+};
+
+constexpr FlightController::StateInfo FlightController::Table::states[];
+constexpr FlightController::TransitionRule FlightController::Table::rules[];
+
+
+/** @brief   Create a disabled controller with the default gains and schedules.
+ *  @param   dt The nominal time between runs (ms)
+ */
+FlightController::FlightController (float dt)
+    : attitude_bank (dt)
+{
+    // Check the tables when they're compiled
+    static_assert (Table::states_in_order (0),
+                   "The state table must have one row per state, in order");
+    static_assert (Table::rules_valid (0),
+                   "Each transition must join two states and have a guard");
+    static_assert (Table::RULE_COUNT < TRIGGER_COMMAND,
+                   "Too many transitions to record in a StateTransition");
+
+    state = STATE_DISABLED;
+    delay_time = 0;
+    last_sequence = 0;
+    stale_samples = 0;
+    memset (&transitions, 0, sizeof (transitions));
+
+    // The allowable surface angles (deg)
+    attitude_bank.set_limits (RUDDER_AXIS, -50, 50);
+    attitude_bank.set_limits (ELEVATOR_AXIS, -50, 50);
+    attitude_bank.set_filter (RUDDER_AXIS, ATTITUDE_D_FILTER_MS);
+    attitude_bank.set_filter (ELEVATOR_AXIS, ATTITUDE_D_FILTER_MS);
+
+    set_gains (DEFAULT_GAINS);
+    set_schedules (DEFAULT_SCHEDULES);
+    enter_disabled ();
+}
+
+
+/** @brief   Use a new set of gains.
+ *  @details The attitude gains take effect, scheduled, with the next sample.
+ *  @param   new_gains The gains, of which the attitude loop's are used
+ */
+void FlightController::set_gains (const GainSet& new_gains)
+{
+    gains = new_gains;
+}
+
+
+/** @brief   Use a new set of gain schedules.
+ *  @details A schedule which isn't valid is ignored and the old one kept.
+ *  @param   schedules The attitude controllers' gain schedules
+ */
+void FlightController::set_schedules (const ScheduleSet& schedules)
+{
+    for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
+    {
+        schedulers[axis].load (schedules.attitude[axis]);
+    }
+}
+
+
+/** @brief   Set a setpoint which doesn't drive the motors.
+ *  @param   autotune Whether the surface loop is to autotune itself
+ */
+void FlightController::set_idle (bool autotune)
+{
+    setpoint.active = false;
+    setpoint.autotune = autotune;
+    for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
+    {
+        setpoint.angle[axis] = 0;
+    }
+    setpoint.sample_us = 0;
+}
+
+
+/** @brief   Leave the present state and enter another, logging the change.
+ *  @param   new_state The state to enter
+ *  @param   trigger The number of the transition taken, or @c TRIGGER_COMMAND
+ *  @param   time_ms The present time (ms)
+ */
+void FlightController::change_state (uint8_t new_state, uint8_t trigger,
+                                     uint32_t time_ms)
+{
+    if (Table::states[state].exit)
+    {
+        (this->*Table::states[state].exit) ();
+    }
+
+    StateTransition& entry
+        = transitions.entries[transitions.count++ % TRANSITION_LOG_SIZE];
+    entry.time_ms = time_ms;
+    entry.from = state;
+    entry.to = new_state;
+    entry.trigger = trigger;
+
+    state = new_state;
+    if (Table::states[state].entry)
+    {
+        (this->*Table::states[state].entry) ();
+    }
+}
+
+
+/** @brief   Run the state machine once.
+ *  @details A change of state asked for from outside is made first. Then the
+ *           present state's "during" action is run, and then the first
+ *           transition out of the state whose guard is true, if any, is taken.
+ *  @param   inputs The measurements from the sensors
+ *  @returns @c true if the setpoint should be sent to the surface loop
+ */
+bool FlightController::run (const ControllerInputs& inputs)
+{
+    bool changed = false;
+    if (inputs.command < STATE_COUNT && inputs.command != state)
+    {
+        change_state (inputs.command, TRIGGER_COMMAND, inputs.time_ms);
+        changed = true;
+    }
+
+    bool fresh = (this->*Table::states[state].during) (inputs);
+
+    for (uint8_t index = 0; index < Table::RULE_COUNT; index++)
+    {
+        const TransitionRule& rule = Table::rules[index];
+        if (rule.from == state && (this->*rule.guard) (inputs))
+        {
+            change_state (rule.to, index, inputs.time_ms);
+            changed = true;
+            break;
+        }
+    }
+    return fresh || changed;
+}
+
+
+/** @brief   Entry action of state 0: stop the motors and forget the past.
+ */
+void FlightController::enter_disabled (void)
+{
+    delay_time = 0;
+    set_idle (false);
+    attitude_bank.reset ();             // Start afresh when reactivated
+}
+
+
+/** @brief   Entry action of state 1: start timing the launch.
+ */
+void FlightController::enter_waiting (void)
+{
+    delay_time = 0;
+    set_idle (false);
+}
+
+
+/** @brief   Entry action of state 2: start timing the landing.
+ *  @details The setpoints start from the attitude at the first sample.
+ */
+void FlightController::enter_active (void)
+{
+    delay_time = 0;
+    attitude_bank.reset ();
+    for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
+    {
+        shapers[axis].reset ();
+    }
+}
+
+
+/** @brief   Entry action of state 3: ask the surface loop to tune itself.
+ */
+void FlightController::enter_autotune (void)
+{
+    set_idle (true);
+}
+
+
+/** @brief   Exit action of states 2 and 3: stop driving the surfaces.
+ */
+void FlightController::stop_surfaces (void)
+{
+    set_idle (false);
+}
+
+
+/** @brief   Action in states 0 and 3: keep sending the idle setpoint.
+ *  @returns @c true, as the setpoint is always sent
+ */
+bool FlightController::hold_idle (const ControllerInputs&)
+{
+    return true;
+}
+
+
+/** @brief   Action in state 1: add up the time spent off the ground.
+ *  @param   inputs The measurements from the sensors
+ *  @returns @c true, as the idle setpoint is always sent
+ */
+bool FlightController::wait_for_launch (const ControllerInputs& inputs)
+{
+    if (!inputs.near_ground)
+    {
+        delay_time += inputs.elapsed_ms;
+    }
+    else
+    {
+        delay_time = 0;
+    }
+    return true;
+}
+
+
+/** @brief   Action in state 2: hold the attitude and time the landing.
+ *  @param   inputs The measurements from the sensors
+ *  @returns @c true if a new sample produced a new setpoint
+ */
+bool FlightController::control_attitude (const ControllerInputs& inputs)
+{
+    // Time how long the plane is near the ground
+    if (inputs.near_ground)
+    {
+        delay_time += inputs.elapsed_ms;
+    }
+    else
+    {
+        delay_time = 0;
+    }
+
+    // If the IMU hasn't produced a new sample since the last run, hold the
+    // desired surface angles rather than feeding the same sample to the
+    // attitude loops twice
+    const AttitudeSample& sample = inputs.sample;
+    if (sample.sequence == last_sequence)
+    {
+        stale_samples++;
+        return false;
+    }
+    last_sequence = sample.sequence;
+
+    // The wings are held level, and the nose raised as the ground nears.
+    // The attitudes wanted are smoothed so the loops never see a step. The
+    // rudder loop acts on the IMU's roll angle
+    float measured[SURFACE_AXES];
+    float target[SURFACE_AXES];
+    float desired[SURFACE_AXES];
+    measured[RUDDER_AXIS] = sample.roll;
+    target[RUDDER_AXIS] = 0;
+    measured[ELEVATOR_AXIS] = sample.pitch;
+    target[ELEVATOR_AXIS] = flare_pitch (inputs.height, inputs.descent_rate);
+    for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
+    {
+        desired[axis] = shapers[axis].update (target[axis], measured[axis],
+                                              sample.time_us);
+    }
+
+    // Multiply the gains by the factors from their schedules. The surface
+    // angles which result are saturated by the bank
+    for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
+    {
+        const GainScheduler& scheduler = schedulers[axis];
+        PIDGains factor = scheduler.lookup (
+            (scheduler.get_input () == SCHEDULE_BY_PITCH) ? sample.pitch
+                                                          : inputs.height);
+        attitude_bank.set_gains (axis, gains.attitude[axis].Kp * factor.Kp,
+                                 gains.attitude[axis].Ki * factor.Ki,
+                                 gains.attitude[axis].Kd * factor.Kd);
+    }
+    attitude_bank.update (measured, desired, setpoint.angle, sample.time_us);
+
+    // The setpoint carries the time of the sample, so the surface loop can
+    // measure the latency from sensor to motor
+    setpoint.active = true;
+    setpoint.autotune = false;
+    setpoint.sample_us = sample.time_us;
+    return true;
+}
+
+
+/** @brief   Guard from state 1 to 2: off the ground for @c LAUNCH_DELAY.
+ *  @returns @c true if the glider has been launched
+ */
+bool FlightController::launched (const ControllerInputs&) const
+{
+    return delay_time >= LAUNCH_DELAY;
+}
+
+
+/** @brief   Guard from state 2 to 0: near the ground for @c LANDED_DELAY.
+ *  @returns @c true if the glider has landed
+ */
+bool FlightController::landed (const ControllerInputs&) const
+{
+    return delay_time >= LANDED_DELAY;
+}
+
+
+/** @brief   Guard from state 3 to 0: the surface loop has finished tuning.
+ *  @param   inputs The measurements from the sensors
+ *  @returns @c true if the autotune has finished
+ */
+bool FlightController::tuned (const ControllerInputs& inputs) const
+{
+    return inputs.tune_finished;
+}
+
+
+/** @brief   Return the name of a state.
+ *  @param   a_state The state
+ *  @returns The name, or @c "unknown" for a number which isn't a state
+ */
+const char* FlightController::get_state_name (uint8_t a_state)
+{
+    return (a_state < STATE_COUNT) ? Table::states[a_state].name : "unknown";
+}
+
+
+/** @brief   Return the name of the trigger of a change of state.
+ *  @param   trigger The number of the transition, or @c TRIGGER_COMMAND
+ *  @returns The transition's name, or @c "command" for a change asked for
+ *           from outside
+ */
+const char* FlightController::get_trigger_name (uint8_t trigger)
+{
+    if (trigger == TRIGGER_COMMAND)
+    {
+        return "command";
+    }
+    return (trigger < Table::RULE_COUNT) ? Table::rules[trigger].name : "unknown";
+}
+
+
+/** @brief   Print a transition log as a table, oldest change first.
+ *  @param   log The transition log
+ *  @param   printer The device to print on, such as @c Serial
+ */
+void print_transitions (const TransitionLog& log, Print& printer)
+{
+    uint32_t first = (log.count > TRANSITION_LOG_SIZE)
+                     ? log.count - TRANSITION_LOG_SIZE : 0;
+    printer.printf ("State changes: %u\r\n", (unsigned)log.count);
+    for (uint32_t index = first; index < log.count; index++)
+    {
+        const StateTransition& entry = log.entries[index % TRANSITION_LOG_SIZE];
+        printer.printf ("%10u ms  %-16s -> %-16s (%s)\r\n",
+                        (unsigned)entry.time_ms,
+                        FlightController::get_state_name (entry.from),
+                        FlightController::get_state_name (entry.to),
+                        FlightController::get_trigger_name (entry.trigger));
+    }
+}
+
+
+/** @brief   Print a transition log as JSON, oldest change first.
+ *  @details The object holds the number of changes since startup as
+ *           @c "count" and the latest changes as the array @c "transitions",
+ *           each with @c "ms", @c "from", @c "to" and @c "trigger".
+ *  @param   log The transition log
+ *  @param   printer The device to print on
+ */
+void print_transitions_json (const TransitionLog& log, Print& printer)
+{
+    uint32_t first = (log.count > TRANSITION_LOG_SIZE)
+                     ? log.count - TRANSITION_LOG_SIZE : 0;
+    printer.printf ("{\"count\":%u,\"transitions\":[", (unsigned)log.count);
+    for (uint32_t index = first; index < log.count; index++)
+    {
+        const StateTransition& entry = log.entries[index % TRANSITION_LOG_SIZE];
+        printer.printf ("%s{\"ms\":%u,\"from\":\"%s\",\"to\":\"%s\",\"trigger\":\"%s\"}",
+                        (index > first) ? "," : "", (unsigned)entry.time_ms,
+                        FlightController::get_state_name (entry.from),
+                        FlightController::get_state_name (entry.to),
+                        FlightController::get_trigger_name (entry.trigger));
+    }
+    printer.print ("]}");
+}
@@ -0,0 +1,223 @@
+/** @file    flightcontrol.h
+ *  @brief   Headers for the attitude controller's state machine.
+ *  @details The logic of the controller task is kept in a class which knows
+ *           nothing of tasks, shares or hardware: each time it runs it is
+ *           given the latest measurements and produces a surface setpoint.
+ *           The controller task on the ESP32 fills in the measurements from
+ *           shares, and the simulator in @c src/sim fills them in from a
+ *           model of the glider, so both run exactly the same control code.
+ *
+ *           The state machine is a pair of tables fixed at compile time. One
+ *           gives each state's entry, exit and "during" actions; the other
+ *           lists the transitions, each with the guard which must be true
+ *           for it to be taken. Every change of state is recorded with its
+ *           time in a small @c TransitionLog which can be printed on demand.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file, from the loop in @c task_controller
+ *  @date   2026-Oct-16 State machine driven by constant tables; transition log
+ *  @date   2026-Oct-16 Smooth attitude setpoints; flare by height and descent rate
+ */
+
+#ifndef _FLIGHTCONTROL_H_
+#define _FLIGHTCONTROL_H_
+
+#include <Arduino.h>
+#include "attitude.h"
+#include "surfaces.h"
+#include "gains.h"
+#include "gainschedule.h"
+#include "pidbank.h"
+#include "flare.h"
+
+
+/// Height below which the glider counts as near the ground (cm)
+#define NEAR_GROUND_DISTANCE 20
+
+/// Time for which the glider must be off the ground before control starts (ms)
+#define LAUNCH_DELAY 2000
+
+/// Time for which the glider must be near the ground before control stops (ms)
+#define LANDED_DELAY 2000
+
+/// Number of state changes kept in a @c TransitionLog
+#define TRANSITION_LOG_SIZE 16
+
+/// Value of @c ControllerInputs::command when no new state is asked for
+#define STATE_NO_COMMAND 0xFF
+
+/// Trigger recorded for a change of state asked for from outside
+#define TRIGGER_COMMAND 0xFF
+
+
+/** @brief  The states of the attitude controller.
+ */
+enum ControllerState : uint8_t
+{
+    STATE_DISABLED = 0,                 ///< Motors off, waiting for the web page
+    STATE_WAIT_FOR_LAUNCH = 1,          ///< Waiting to be off the ground
+    STATE_ACTIVE = 2,                   ///< Holding attitude, flaring near the ground
+    STATE_AUTOTUNE = 3,                 ///< The surface loop is tuning itself
+    STATE_COUNT                         ///< Number of states
+};
+
+
+/** @brief  The measurements used by one run of the attitude controller.
+ */
+struct ControllerInputs
+{
+    uint32_t time_ms;                   ///< Present time (ms)
+    uint32_t elapsed_ms;                ///< Time since the previous run (ms)
+    uint8_t command;                    ///< State asked for from outside, or
+                                        ///< @c STATE_NO_COMMAND
+    bool near_ground;                   ///< Whether the glider is near the ground
+    float height;                       ///< Height from the ultrasonic sensor (cm)
+    float descent_rate;                 ///< Rate of descent from the heights (cm/s)
+    AttitudeSample sample;              ///< Latest attitude sample from the IMU
+    bool tune_finished;                 ///< Whether an autotune has just finished
+};
+
+
+/** @brief  One change of state.
+ */
+struct StateTransition
+{
+    uint32_t time_ms;                   ///< Time of the change (ms)
+    uint8_t from;                       ///< State left
+    uint8_t to;                         ///< State entered
+    uint8_t trigger;                    ///< Number of the transition taken, or
+                                        ///< @c TRIGGER_COMMAND
+};
+
+
+/** @brief  The most recent changes of state, in a ring buffer.
+ *  @details The newest change is at @c entries[(count - 1) % TRANSITION_LOG_SIZE].
+ *           The log is small and plain, so it may be copied through a share
+ *           to the task which prints it.
+ */
+struct TransitionLog
+{
+    uint32_t count;                     ///< Number of changes since startup
+    StateTransition entries[TRANSITION_LOG_SIZE];   ///< The latest changes
+};
+
+
+/** @brief   Class which runs the attitude controller's state machine.
+ *  @details In the active state, each new IMU sample is run through a bank
+ *           of controllers, one per surface, whose gains are scheduled by
+ *           height or pitch; the resulting surface angles go into the
+ *           setpoint for the surface loop. The attitudes wanted, level in the
+ *           cruise and nose up in the flare, are smoothed by a
+ *           @c SetpointGenerator for each axis. The state may also be changed
+ *           from outside, as the web page does, through @c ControllerInputs.
+ */
+class FlightController
+{
+protected:
+    /// An entry or exit action
+    typedef void (FlightController::*Action) (void);
+
+    /// An action run each time in a state; returns whether to send the setpoint
+    typedef bool (FlightController::*Activity) (const ControllerInputs& inputs);
+
+    /// A condition which must be true for a transition to be taken
+    typedef bool (FlightController::*Guard) (const ControllerInputs& inputs) const;
+
+    /// @brief What a state does, one row of the state table
+    struct StateInfo
+    {
+        uint8_t state;                  ///< The state, which must match its row
+        const char* name;               ///< Name for the transition log
+        Action entry;                   ///< Run on entering the state, or null
+        Activity during;                ///< Run each time in the state
+        Action exit;                    ///< Run on leaving the state, or null
+    };
+
+    /// @brief One row of the transition table
+    struct TransitionRule
+    {
+        uint8_t from;                   ///< State in which the rule is checked
+        uint8_t to;                     ///< State entered if the guard is true
+        Guard guard;                    ///< Condition for the transition
+        const char* name;               ///< Name for the transition log
+    };
+
+    /// The state and transition tables, in flightcontrol.cpp
+    struct Table;
+
+    uint8_t state;                      ///< Present state, a @c ControllerState
+    uint16_t delay_time;                ///< Time spent waiting to change state (ms)
+    TransitionLog transitions;          ///< Recent changes of state
+
+    PIDBank<SURFACE_AXES> attitude_bank;    ///< Yaw to rudder and pitch to elevator
+    GainScheduler schedulers[SURFACE_AXES]; ///< Schedules for the bank's gains
+    GainSet gains;                      ///< Gains before scheduling
+    SetpointGenerator shapers[SURFACE_AXES];    ///< Smooth the attitudes wanted
+
+    uint32_t last_sequence;             ///< Sequence number of the last sample used
+    uint32_t stale_samples;             ///< Number of active runs with no new sample
+    SurfaceSetpoint setpoint;           ///< Setpoint for the surface loop
+
+    // Set a setpoint which doesn't drive the motors
+    void set_idle (bool autotune);
+
+    // Leave the present state and enter another, logging the change
+    void change_state (uint8_t new_state, uint8_t trigger, uint32_t time_ms);
+
+    // Entry and exit actions
+    void enter_disabled (void);
+    void enter_waiting (void);
+    void enter_active (void);
+    void enter_autotune (void);
+    void stop_surfaces (void);
+
+    // Actions run each time in a state
+    bool hold_idle (const ControllerInputs& inputs);
+    bool wait_for_launch (const ControllerInputs& inputs);
+    bool control_attitude (const ControllerInputs& inputs);
+
+    // Guards
+    bool launched (const ControllerInputs& inputs) const;
+    bool landed (const ControllerInputs& inputs) const;
+    bool tuned (const ControllerInputs& inputs) const;
+
+public:
+    // Create a disabled controller with the default gains and schedules
+    FlightController (float dt);
+
+    // Use a new set of gains
+    void set_gains (const GainSet& new_gains);
+
+    // Use a new set of gain schedules
+    void set_schedules (const ScheduleSet& schedules);
+
+    /// Return the present state
+    uint8_t get_state (void) const { return state; }
+
+    // Run the state machine once
+    bool run (const ControllerInputs& inputs);
+
+    /// Return the setpoint for the surface loop
+    const SurfaceSetpoint& get_setpoint (void) const { return setpoint; }
+
+    /// Return the number of active runs in which there was no new sample
+    uint32_t get_stale_samples (void) const { return stale_samples; }
+
+    /// Return the recent changes of state
+    const TransitionLog& get_transitions (void) const { return transitions; }
+
+    // Return the name of a state
+    static const char* get_state_name (uint8_t a_state);
+
+    // Return the name of the trigger of a change of state
+    static const char* get_trigger_name (uint8_t trigger);
+};
+
+
+// Print a transition log as a table, oldest change first
+void print_transitions (const TransitionLog& log, Print& printer);
+
+// Print a transition log as JSON, oldest change first
+void print_transitions_json (const TransitionLog& log, Print& printer);
+
+#endif // _FLIGHTCONTROL_H_
@@ -0,0 +1,51 @@
+/** @file gains.h
+ *  @brief This file contains the structures which carry controller gains from
+ *         the web server to the control loops, and the default gains.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#ifndef _GAINS_H_
+#define _GAINS_H_
+
+#include <Arduino.h>
+#include "surfaces.h"
+
+/** @brief  The gains of one PID controller.
+ */
+struct PIDGains
+{
+    float Kp;               ///< Proportional gain
+    float Ki;               ///< Integral gain (per ms)
+    float Kd;               ///< Derivative gain (ms)
+};
+
+/** @brief  The gains of every controller in the attitude and surface loops.
+ *  @details Each loop has one controller per control surface, indexed by
+ *           @c SurfaceAxis. The attitude loop's controllers turn attitude
+ *           errors into surface angles; the surface loop's turn surface angle
+ *           errors into motor duty cycles.
+ */
+struct GainSet
+{
+    PIDGains attitude[SURFACE_AXES];    ///< Yaw to rudder and pitch to elevator
+    PIDGains surface[SURFACE_AXES];     ///< Rudder and elevator to duty cycle
+};
+
+/// The gains used at startup and restored by the web page's reset button
+const GainSet DEFAULT_GAINS =
+{
+    { {1, 0, 0}, {1, 0, 0} },           // Attitude loop: rudder, elevator
+    { {3, 0, 0}, {3, 0, 0} }            // Surface loop: rudder, elevator
+};
+
+/// Time constant of the attitude loop's derivative filters, two IMU samples
+/// at 100 Hz (ms)
+const float ATTITUDE_D_FILTER_MS = 20;
+
+/// Time constant of the surface loop's derivative filters, which smooth the
+/// potentiometers' noise over a few passes at 500 Hz (ms)
+const float SURFACE_D_FILTER_MS = 5;
+
+#endif // _GAINS_H_
@@ -0,0 +1,117 @@
+/** @file    gainschedule.cpp
+ *  @brief   Source code for tables which change the attitude controllers'
+ *           gains with height or pitch.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#include "gainschedule.h"
+
+
+/** @brief   Check that a schedule's breakpoints are usable.
+ *  @details A schedule needs between 1 and @c SCHEDULE_POINTS breakpoints,
+ *           with inputs which increase from each one to the next and finite
+ *           factors.
+ *  @param   schedule The schedule to be checked
+ *  @returns @c true if the schedule can be loaded
+ */
+bool schedule_is_valid (const GainSchedule& schedule)
+{
+    if (schedule.points < 1 || schedule.points > SCHEDULE_POINTS
+        || schedule.input > SCHEDULE_BY_PITCH)
+    {
+        return false;
+    }
+    for (uint8_t index = 0; index < schedule.points; index++)
+    {
+        const GainBreakpoint& point = schedule.table[index];
+        if (!isfinite (point.input) || !isfinite (point.scale.Kp)
+            || !isfinite (point.scale.Ki) || !isfinite (point.scale.Kd))
+        {
+            return false;
+        }
+        if (index > 0 && !(point.input > schedule.table[index - 1].input))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/** @brief   Create a scheduler whose factors are all 1.
+ */
+GainScheduler::GainScheduler (void)
+{
+    input = SCHEDULE_BY_HEIGHT;
+    points = 1;
+    breakpoint[0] = 0;
+    value[0] = {1, 1, 1};
+    slope[0] = {0, 0, 0};
+}
+
+
+/** @brief   Load a schedule, checking it and finding the slopes of its
+ *           segments.
+ *  @param   schedule The schedule to be used
+ *  @returns @c true if the schedule was loaded, @c false if it was invalid
+ *           and the previous one was kept
+ */
+bool GainScheduler::load (const GainSchedule& schedule)
+{
+    if (!schedule_is_valid (schedule))
+    {
+        return false;
+    }
+
+    input = schedule.input;
+    points = schedule.points;
+    for (uint8_t index = 0; index < points; index++)
+    {
+        breakpoint[index] = schedule.table[index].input;
+        value[index] = schedule.table[index].scale;
+        slope[index] = {0, 0, 0};
+        if (index > 0)
+        {
+            const PIDGains& left = value[index - 1];
+            float width = breakpoint[index] - breakpoint[index - 1];
+            slope[index - 1].Kp = (value[index].Kp - left.Kp) / width;
+            slope[index - 1].Ki = (value[index].Ki - left.Ki) / width;
+            slope[index - 1].Kd = (value[index].Kd - left.Kd) / width;
+        }
+    }
+    return true;
+}
+
+
+/** @brief   Find the gain factors at a given input.
+ *  @details The factors are interpolated between the breakpoints on either
+ *           side of @c x, or are those of the first or last breakpoint if
+ *           @c x is outside the table. An @c x which isn't a number gets the
+ *           first breakpoint's factors.
+ *  @param   x The height (cm) or pitch (deg)
+ *  @returns Factors by which to multiply Kp, Ki and Kd
+ */
+PIDGains GainScheduler::lookup (float x) const
+{
+    // This is also true if x isn't a number, such as from a failed reading
+    if (!(x > breakpoint[0]))
+    {
+        return value[0];
+    }
+
+    uint8_t index = points - 1;
+    while (index > 0 && x < breakpoint[index])
+    {
+        index--;
+    }
+
+    // Past the last breakpoint the slope is zero, so the factors are held
+    float offset = x - breakpoint[index];
+    PIDGains factors;
+    factors.Kp = value[index].Kp + slope[index].Kp * offset;
+    factors.Ki = value[index].Ki + slope[index].Ki * offset;
+    factors.Kd = value[index].Kd + slope[index].Kd * offset;
+    return factors;
+}
@@ -0,0 +1,132 @@
+/** @file    gainschedule.h
+ *  @brief   Headers for tables which change the attitude controllers' gains
+ *           with height or pitch.
+ *  @details A gain schedule is a short table of breakpoints. Each breakpoint
+ *           gives the factors by which the proportional, integral and
+ *           derivative gains are multiplied at one height or pitch angle;
+ *           between breakpoints the factors are interpolated linearly, and
+ *           beyond the ends they are held at the end values. The factors
+ *           multiply the gains set from the web page, so a schedule whose
+ *           factors are all 1 leaves the gains as they are.
+ *
+ *           The default tables are @c constexpr arrays at the bottom of this
+ *           file. New tables may be sent from the web page while the glider
+ *           flies; they travel through the @c gain_schedules share just as
+ *           new gains do.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#ifndef _GAINSCHEDULE_H_
+#define _GAINSCHEDULE_H_
+
+#include <Arduino.h>
+#include "gains.h"
+
+
+/// Largest number of breakpoints in one gain schedule
+#define SCHEDULE_POINTS 6
+
+
+/** @brief  The measurement by which a gain schedule is looked up.
+ */
+enum ScheduleInput : uint8_t
+{
+    SCHEDULE_BY_HEIGHT = 0,             ///< Height from the ultrasonic sensor (cm)
+    SCHEDULE_BY_PITCH                   ///< Pitch angle from the IMU (deg)
+};
+
+
+/** @brief  One point in a gain schedule.
+ */
+struct GainBreakpoint
+{
+    float input;                        ///< Height (cm) or pitch (deg)
+    PIDGains scale;                     ///< Factors for Kp, Ki and Kd there
+};
+
+
+/** @brief  A gain schedule for one controller.
+ *  @details The breakpoints must be in order of increasing input.
+ */
+struct GainSchedule
+{
+    ScheduleInput input;                ///< What the schedule is looked up by
+    uint8_t points;                     ///< Number of breakpoints used
+    GainBreakpoint table[SCHEDULE_POINTS];  ///< The breakpoints
+};
+
+
+/** @brief  The gain schedules of the attitude controllers, indexed by
+ *          @c SurfaceAxis.
+ */
+struct ScheduleSet
+{
+    GainSchedule attitude[SURFACE_AXES];    ///< Yaw to rudder and pitch to elevator
+};
+
+
+/** @brief   Class which looks up gain factors in a gain schedule.
+ *  @details When a schedule is loaded, the slope of each segment between
+ *           breakpoints is worked out, so a lookup is a short search and one
+ *           multiplication and addition for each gain.
+ */
+class GainScheduler
+{
+protected:
+    ScheduleInput input;                ///< What the schedule is looked up by
+    uint8_t points;                     ///< Number of breakpoints
+    float breakpoint[SCHEDULE_POINTS];  ///< Inputs at the breakpoints
+    PIDGains value[SCHEDULE_POINTS];    ///< Factors at the breakpoints
+    PIDGains slope[SCHEDULE_POINTS];    ///< Change of factors per unit input
+
+public:
+    // Create a scheduler whose factors are all 1
+    GainScheduler (void);
+
+    // Load a schedule, checking it and finding the slopes of its segments
+    bool load (const GainSchedule& schedule);
+
+    // Find the gain factors at a given input
+    PIDGains lookup (float x) const;
+
+    /// Return what the schedule is looked up by
+    ScheduleInput get_input (void) const { return input; }
+};
+
+
+// Check that a schedule's breakpoints are usable
+bool schedule_is_valid (const GainSchedule& schedule);
+
+
+/// Factors which leave the gains unchanged at any height
+constexpr GainSchedule RUDDER_SCHEDULE =
+{
+    SCHEDULE_BY_HEIGHT, 2,
+    {
+        {0,   {1, 1, 1}},
+        {400, {1, 1, 1}}
+    }
+};
+
+/// Factors for the elevator, with breakpoints around the flare height. They
+/// are all 1 until flight tests show how the gains should change
+constexpr GainSchedule ELEVATOR_SCHEDULE =
+{
+    SCHEDULE_BY_HEIGHT, 4,
+    {
+        {0,   {1, 1, 1}},
+        {20,  {1, 1, 1}},
+        {60,  {1, 1, 1}},
+        {400, {1, 1, 1}}
+    }
+};
+
+/// The schedules used at startup and restored by the web page
+constexpr ScheduleSet DEFAULT_SCHEDULES =
+{
+    { RUDDER_SCHEDULE, ELEVATOR_SCHEDULE }
+};
+
+#endif // _GAINSCHEDULE_H_
@@ -0,0 +1,70 @@
+/** @file    gainstore.cpp
+ *  @brief   Source code for functions which keep the controller gains in
+ *           flash.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#include <Preferences.h>
+#include "gainstore.h"
+
+/// Name of the non-volatile storage area used by this program
+#define GAIN_STORE_NAMESPACE "airheads"
+
+/// Key under which the gains are saved
+#define GAIN_STORE_KEY "gains"
+
+
+/** @brief   Read the saved gains from flash.
+ *  @details Gains saved by a version of the program with a different
+ *           @c GainSet, such as one with more control surfaces, are ignored.
+ *  @param   gains Set to the saved gains, if there are any
+ *  @returns @c true if saved gains were found and read
+ */
+bool load_saved_gains (GainSet& gains)
+{
+    Preferences store;
+    if (!store.begin (GAIN_STORE_NAMESPACE, true))
+    {
+        return false;
+    }
+
+    bool found = false;
+    if (store.isKey (GAIN_STORE_KEY)
+        && store.getBytesLength (GAIN_STORE_KEY) == sizeof (GainSet))
+    {
+        GainSet saved;
+        found = (store.getBytes (GAIN_STORE_KEY, &saved, sizeof (GainSet))
+                 == sizeof (GainSet));
+        if (found)
+        {
+            gains = saved;
+        }
+    }
+    store.end ();
+    return found;
+}
+
+
+/** @brief   Save gains in flash.
+ *  @details Writing flash takes a few milliseconds, during which the flash
+ *           cache is turned off on both cores. Every task which runs code
+ *           from flash, including the control loops on core 1, stalls until
+ *           the write is done, so this should only be called while the
+ *           controller is disabled.
+ *  @param   gains The gains to be saved
+ *  @returns @c true if the gains were saved
+ */
+bool save_gains (const GainSet& gains)
+{
+    Preferences store;
+    if (!store.begin (GAIN_STORE_NAMESPACE, false))
+    {
+        return false;
+    }
+    bool saved = (store.putBytes (GAIN_STORE_KEY, &gains, sizeof (GainSet))
+                  == sizeof (GainSet));
+    store.end ();
+    return saved;
+}
@@ -0,0 +1,23 @@
+/** @file    gainstore.h
+ *  @brief   Headers for functions which keep the controller gains in flash.
+ *  @details Gains found by the autotuner, or set from the web page and then
+ *           saved from it, are kept in the ESP32's non-volatile storage, so
+ *           they are used again after the glider is switched off and on.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#ifndef _GAINSTORE_H_
+#define _GAINSTORE_H_
+
+#include <Arduino.h>
+#include "gains.h"
+
+// Read the saved gains from flash
+bool load_saved_gains (GainSet& gains);
+
+// Save gains in flash
+bool save_gains (const GainSet& gains);
+
+#endif // _GAINSTORE_H_
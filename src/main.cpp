@@ -3,29 +3,88 @@
  *  @details Includes ultrasonic sensor, potentiometer, motor driver, and flight controller tasks.
  *  @author ME 507 Airheads
  *  @date 2022-Nov-10 
+ *  @date 2026-Oct-16 Tasks run from statically allocated stacks
+ *  @date 2026-Oct-16 Tasks run at fixed periods with timing statistics
+ *  @date 2026-Oct-16 Tasks pinned to cores and profiled in CPU cycles
+ *  @date 2026-Oct-16 Controller runs on each IMU sample; latency measured
+ *  @date 2026-Oct-16 Surface position loops moved to a fast timer-driven task
+ *  @date 2026-Oct-16 Each loop's axes run together in a bank of controllers
+ *  @date 2026-Oct-16 Controllers use measured time steps; reset when idle
+ *  @date 2026-Oct-16 Controller gains may be changed from the web page
+ *  @date 2026-Oct-16 Attitude gains scheduled by height or pitch
+ *  @date 2026-Oct-16 Added an autotune state for the surface loops
+ *  @date 2026-Oct-16 Control logic moved into classes shared with the simulator
+ *  @date 2026-Oct-16 Controller state read once per run; state changes logged
+ *  @date 2026-Oct-16 Rate of descent measured for a smooth flare
+ *  @date 2026-Oct-16 IMU attitude filtered with microsecond time steps
+ *  @date 2026-Oct-16 Angles converted to degrees in single precision
+ *  @date 2026-Oct-16 Time taken to read the IMU measured
+ *  @date 2026-Oct-16 IMU samples batched in the sensor's FIFO
+ *  @date 2026-Oct-16 IMU task woken by the sensor's interrupt line
  */
 
 #include <Arduino.h>
 #include "shares.h"
 #include "taskshare.h"
+#include "periodictask.h"
+#include "profiler.h"
 #include "PrintStream.h"
-#include <time.h>
 #include <network.h>
 
 // Modules
 #include "DRV8871.h"
 #include "ultrasonic.h"
 #include "potentiometer.h"
-#include "PIDController.h"
+#include "flightcontrol.h"
+#include "surfaceloop.h"
 #include "IMU.h"
+#include "fastmath.h"
 
 // Shares
 Share<bool> near_ground ("Near Ground");                    ///< A share boolean that reads true if the glider is near ground
 Share<uint8_t> tc_state ("Task Controller State");          ///< A share integer for finite state machine
-Share<int16_t> rudder_duty ("Rudder motor duty cycle");     ///< A share containing the duty cycle for rudder motor
-Share<int16_t> elev_duty ("Elevator motor duty cycle");     ///< A share containing the duty cycle for elevator motor
-Share<float> yawC ("Current yaw from IMU");                 ///< A share containing current yaw of the glider
-Share<float> pitchC ("Current pitch from IMU");             ///< A share containing current pitch of the glider
+SeqShare<AttitudeSample> attitude ("Attitude from IMU");   ///< A share containing the latest attitude sample of the glider
+SeqShare<IMUStatus> imu_status ("IMU status");             ///< A share containing the IMU's bus clock, failed raw reads and FIFO overruns
+SeqShare<SurfaceSetpoint> surface_setpoint ("Surface setpoint"); ///< A share containing the surface angles wanted by the controller
+SeqShare<SurfaceState> surface_state ("Surface state");    ///< A share containing the surface angles and motor duty cycles
+SeqShare<GainSet> controller_gains ("Controller gains");   ///< A share containing gains set from the web page
+SeqShare<ScheduleSet> gain_schedules ("Gain schedules");   ///< A share containing gain schedules set from the web page
+SeqShare<MahonyGains> filter_gains ("Filter gains");        ///< A share containing attitude filter gains set from the web page
+SeqShare<TuneResult> autotune_result ("Autotune result");  ///< A share containing the results of autotuning the surface loop
+SeqShare<float> ground_distance ("Ground distance");       ///< A share containing the height measured by the ultrasonic sensor
+SeqShare<float> descent_rate ("Descent rate");             ///< A share containing the rate of descent found from the heights
+SeqShare<TransitionLog> state_transitions ("State changes"); ///< A share containing the controller's recent changes of state
+SeqShare<uint32_t> stale_samples ("Stale samples");        ///< A share containing the number of active runs with no new IMU sample
+
+/// Time from an IMU sample being taken to the motor PWM which it caused
+TimeHistogram surface_latency ("IMU to surface PWM");
+
+/// Bus time per accelerometer and gyro sample. With the FIFO, the time of
+/// each drain is shared among the samples it read, so the figure can be
+/// compared with one read of the sensors without it
+TimeHistogram imu_read_time ("IMU read/sample");
+
+// Control timing. These may be changed with -D options in the build_flags of
+// platformio.ini
+#ifndef IMU_PERIOD
+#define IMU_PERIOD 10               ///< Time between IMU samples (ms)
+#endif
+#ifndef EVENT_DRIVEN_CONTROL
+#define EVENT_DRIVEN_CONTROL true   ///< Run the attitude loop on each new IMU sample, not on a timer
+#endif
+#ifndef ATTITUDE_PERIOD
+#define ATTITUDE_PERIOD 50          ///< Time between attitude loop runs if not event driven (ms)
+#endif
+#ifndef IMU_INTERRUPTS
+#define IMU_INTERRUPTS true         ///< Wake the IMU task from the sensors' interrupt lines, not a timer
+#endif
+#ifndef SURFACE_LOOP_HZ
+#define SURFACE_LOOP_HZ 500         ///< Rate of the surface position loop (Hz)
+#endif
+#define SURFACE_TIMER 0             ///< Hardware timer which runs the surface loop
+
+static_assert (1000 % SURFACE_LOOP_HZ == 0, 
+               "The surface loop period must be a whole number of milliseconds");
 
 // Elevator Motor (Motor 0)
 #define ELEVATOR_PIN_IN1   27       ///< GPIO 27 on ESP32: non-zero signal for (+) duty cycle
@@ -47,367 +106,506 @@ Share<float> pitchC ("Current pitch from IMU");             ///< A share contain
 #define TRIG 12                     ///< GPIO 12 on ESP32: ultrasonic trigger pin
 #define ECHO 13                     ///< GPIO 1 on ESP32: ultrasonic echo pin
 
+// IMU interrupt lines
+#define IMU_INT1_PIN 32             ///< GPIO 32 on ESP32: LSM6DSOX INT1, FIFO watermark or data ready
+#define MAG_DRDY_PIN 14             ///< GPIO 14 on ESP32: LIS3MDL DRDY, new magnetometer data
+
 /** @brief   Ultrasonic sensor measures distance to the ground
  *  @details Ultrasonic sensor mounted on the airplane measures the 
- *           distance from the airplane to the ground. When the airplane
- *           is within 1 foot of the ground, the airplane's control 
- *           surfaces will move into "landing configuration" where the 
- *           pitch will be x degrees up for a soft landing.
- *  @param   p_params A pointer to parameters passed to this task. This 
- *           pointer is ignored; it should be set to @c NULL in the 
- *           call to @c xTaskCreate() which starts this task
+ *           distance from the airplane to the ground, from which the rate
+ *           of descent is found. As the airplane nears the ground, the
+ *           controller raises the pitch smoothly for a soft landing.
+ *  @param   p_params A pointer to this task's @c PeriodicTask object, passed
+ *           by the object's @c start() method
  */
 void task_ultrasonic (void* p_params)
 {
-    Serial << "Ultrasonic Sensor Task Begin" << endl;
+    PeriodicTask* p_task = (PeriodicTask*)p_params;
 
-    // Task period
-    const uint8_t period = 100;
+    Serial << "Ultrasonic Sensor Task Begin" << endl;
 
     // Distance
     float distance;
 
-    // Height and timer threshold
-    const uint8_t threshold = 20;               // cm
-
     // Create object
     Serial.println("Constructing the ultrasonic object");
     Ultrasonic ultra = Ultrasonic(ECHO, TRIG);
+    DescentEstimator descent;
 
     while (true)
     {
         // Get the distance from the sensor
         distance = ultra.get_distance();
+        ground_distance.put(distance);
+        descent_rate.put(descent.update(distance, millis()));
         
-        // If the distance is below height threshold, start counting
-        // Stop counting when counter exceeds 10 seconds to prevent overflow
-        near_ground.put(distance < threshold);
-        vTaskDelay(period);
+        // Only whether the glider is near the ground is shared; the
+        // controller's launch and landing guards decide what that means
+        near_ground.put(distance < NEAR_GROUND_DISTANCE);
+        p_task->wait_for_next_period();
     }
 }
 
 
-/** @brief   Controller for both rudder and elevator control surfaces
- *  @details Retrieves IMU, potentiometer, and ultrasonic sensor data and writes 
- *           motor duty cycles to shares. The motor tasks use the duty cycles
- *           to move the rudder and elevator control surfaces. The states within
- *           this task are set internally and by the webpage task.
- *  @param   p_params An unused pointer to (no) parameters passed to this task
+/** @brief   Attitude controller for both rudder and elevator control surfaces
+ *  @details Retrieves IMU and ultrasonic sensor data and runs them through the
+ *           @c FlightController state machine, which calculates the rudder
+ *           and elevator angles needed to hold the desired attitude. The
+ *           angles are put into @c surface_setpoint, from which the surface
+ *           loop in @c task_surfaces moves the control surfaces. The state is
+ *           set internally and by the webpage task through @c tc_state. When
+ *           @c EVENT_DRIVEN_CONTROL is true the task runs as soon as the IMU
+ *           publishes a sample, with its period as a time limit; otherwise it
+ *           runs once per period. In state 3 the surface loop autotunes
+ *           itself while this task waits for the results. Changes of state
+ *           are put into @c state_transitions, from which they are printed
+ *           with the task report and on the web page's @c /transitions.
+ *           The count of runs with no new sample is put into
+ *           @c stale_samples and printed with the task report too.
+ *  @param   p_params A pointer to this task's @c PeriodicTask object, passed
+ *           by the object's @c start() method
  */
 void task_controller (void* p_params)
 {
-    Serial << "Controller Task Begin" << endl;
-  
-    const uint8_t TASK_CONTROLLER_PERIOD = 50;  ///< Period of controller task (ms)
-
-    // Controller objects
-    PIDController yaw2rudder =      ///< Controller for rudder angle based on yaw
-        PIDController(1,0,0,TASK_CONTROLLER_PERIOD); 
-    PIDController rudder2duty =     ///< Controller for duty cycle based on rudder angle
-        PIDController(3,0,0,TASK_CONTROLLER_PERIOD);
-    PIDController pitch2elev =      ///< Controller for elevator angle based on pitch
-        PIDController(1,0,0,TASK_CONTROLLER_PERIOD);
-    PIDController elev2duty =       ///< Controller for duty cycle based on elevator angle
-        PIDController(3,0,0,TASK_CONTROLLER_PERIOD);
-
-    // Create potentiometer object and zero the current reading
-    Potentiometer rudderPot = Potentiometer(RUDDER_POT_PIN, 0);
-    rudderPot.zero();
-
-    // Create potentiometer object and zero the current reading
-    Potentiometer elevPot = Potentiometer(ELEVATOR_POT_PIN, 0);
-    elevPot.zero();
-
-    // Initialize variables
-    float yawD;                     ///< Desired yaw (deg)
-    float pitchD;                   ///< Desired pitch (deg)  
+    PeriodicTask* p_task = (PeriodicTask*)p_params;
 
-    // Variables to keep track of previous potentiometer reading
-    float prev_rudder = 0;          ///< Rudder position at previous time (deg)
-    float prev_elevator = 0;        ///< Elevator position at previous time (deg)
-
-    float rudderAngleD;             ///< Desired rudder angle (deg)
-    float rudderAngleC;             ///< Current rudder angle (deg)
-    float rudderAngleMin = -50;     ///< Minimum allowable rudder angle (deg)
-    float rudderAngleMax = 50;      ///< Maximum allowable rudder angle (deg)
+    Serial << "Controller Task Begin" << endl;
 
-    float elevAngleD;               ///< Desired elevator angle (deg)
-    float elevAngleC;               ///< Current elevator angle (deg)
-    float elevAngleMin = -50;       ///< Minimum allowable elevator angle (deg)
-    float elevAngleMax = 50;        ///< Maximum allowable elevator angle (deg)
+    // Time between runs of the controller (ms). When it's event driven, it
+    // runs once for each IMU sample
+    const TickType_t TASK_CONTROLLER_PERIOD =
+        EVENT_DRIVEN_CONTROL ? IMU_PERIOD : p_task->get_period();
 
-    float rudderDutyD;              ///< Rudder motor duty cycle (-100% to 100% incl.)
-    float elevDutyD;                ///< Elev motor duty cycle (-100% to 100% incl.)
+    // The controller and the larger structures are static, so they take
+    // about 1 KB of RAM when the program is compiled rather than from this
+    // task's stack. Only this task uses them
+    static FlightController controller (TASK_CONTROLLER_PERIOD);
+    static ControllerInputs inputs; ///< Measurements given to the controller
 
-    uint16_t delay_time = 0;        ///< Current amount of time (ms) in inactive delay
-    tc_state.put(0);                // Initialize at state 0
+    static GainSet gains;           ///< Gains sent from the web page
+    uint32_t gains_seen = 0;        ///< Number of gain updates already loaded
+    static ScheduleSet schedules;   ///< Gain schedules sent from the web page
+    uint32_t schedules_seen = 0;    ///< Number of schedule updates already loaded
 
+    static TuneResult tune_result;  ///< Results of the last autotune
+    uint32_t tunes_seen = 0;        ///< Number of autotune results already seen
+    uint32_t changes_put = 0;       ///< Number of state changes already shared
+    uint32_t stale_put = 0;         ///< Number of stale samples already shared
 
-    // Establish initial conditions for rudder and elevator
-    rudderAngleC = rudderPot.get_angle();
-    prev_rudder = rudderAngleC;
+    uint32_t last_ms = millis();    ///< Time of the previous iteration (ms)
+    tc_state.put(STATE_DISABLED);   // Initialize at state 0
 
-    elevAngleC = elevPot.get_angle();
-    prev_elevator = elevAngleC;
 
-    
-    while (true) 
+    while (true)
     {
+        // The time between iterations varies when the controller is run by
+        // new IMU samples, so the delay counters add up the measured time
+        inputs.time_ms = millis();
+        inputs.elapsed_ms = inputs.time_ms - last_ms;
+        last_ms = inputs.time_ms;
+
+        // Use any gains and schedules which the web page has sent since the
+        // last iteration. They take effect when the next sample is used
+        if (controller_gains.get_if_updated(gains, gains_seen))
+        {
+            controller.set_gains(gains);
+        }
+        if (gain_schedules.get_if_updated(schedules, schedules_seen))
+        {
+            controller.set_schedules(schedules);
+        }
 
-        if (web_calibrate.get()) {        // If the webpage calls for calibration
+        // Read pitch and roll from the same IMU sample
+        inputs.near_ground = near_ground.get();
+        inputs.height = ground_distance.get();
+        inputs.descent_rate = descent_rate.get();
+        attitude.get(inputs.sample);
+        inputs.tune_finished = autotune_result.get_if_updated(tune_result, tunes_seen);
+
+        // The state share is read once. If it differs from the controller's
+        // state, the web page has asked for a new one
+        uint8_t requested = tc_state.get();
+        inputs.command = (requested != controller.get_state()) ? requested
+                                                               : STATE_NO_COMMAND;
+        if (controller.run(inputs))
+        {
+            surface_setpoint.put(controller.get_setpoint());
+        }
+        uint8_t state = controller.get_state();
+        if (state != requested)
+        {
+            tc_state.put(state);
+        }
 
-            rudderPot.zero();             // Stop power to motors
-            elevPot.zero();
+        // Changes of state are shared for printing rather than printed here
+        if (controller.get_transitions().count != changes_put)
+        {
+            state_transitions.put(controller.get_transitions());
+            changes_put = controller.get_transitions().count;
+        }
 
-            web_calibrate.put(0);         // Reset the calibrate flag
+        // The surfaces are printed by loop(), not on every sample here, as
+        // printing would hold up this task on the serial port
+        if (controller.get_stale_samples() != stale_put)
+        {
+            stale_put = controller.get_stale_samples();
+            stale_samples.put(stale_put);
+        }
 
-            Serial << "   Calibrated" << endl;
+        if (inputs.tune_finished)
+        {
+            for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
+            {
+                Serial << "Autotune axis " << axis << ": "
+                       << (tune_result.status[axis] == TUNE_DONE ? "Ku " : "failed, Ku ")
+                       << tune_result.ultimate_gain[axis] << ", Tu "
+                       << tune_result.ultimate_period[axis] << " ms" << endl;
+            }
+        }
 
+        // Wait for the next IMU sample, or for the next period
+        if (EVENT_DRIVEN_CONTROL)
+        {
+            p_task->wait_for_update(attitude);
+        }
+        else
+        {
+            p_task->wait_for_next_period();
         }
 
+    }
+}
 
-        if (tc_state.get() == 0)          // STATE 0: DISABLED
-        {        
 
-            delay_time = 0;               // Reset delay counter
-            rudder_duty.put(0);           // Stop power to motors
-            elev_duty.put(0);
+/// Handle of the surface task, which the surface timer's interrupt wakes
+TaskHandle_t surface_task_handle = NULL;
 
-            // Passive state waiting for external callback to switch state
-            Serial.println(" 0 ");
 
-        }
-        else if (tc_state.get() == 1)     // STATE 1: WAIT FOR LAUNCH
-        {
+/** @brief   Interrupt service routine for the surface loop's hardware timer.
+ *  @details Floating point math can't be done in an ISR on the ESP32, so the
+ *           ISR only wakes the surface task. That task's priority is strictly
+ *           higher than that of every task on its core but ESP-IDF's IPC
+ *           task, which only runs for calls from the other core, so the
+ *           wake-up asks for a context switch and the task runs as soon as
+ *           the ISR returns.
+ */
+void IRAM_ATTR surface_timer_isr (void)
+{
+    BaseType_t wake_up = pdFALSE;
+    vTaskNotifyGiveFromISR (surface_task_handle, &wake_up);
+    portYIELD_FROM_ISR (wake_up);
+}
 
-            Serial.println(" 1 ");
 
-            // Add one task period to accumulated delay time (ms)
-            if (near_ground.get() == 0) 
-            {
-                delay_time += TASK_CONTROLLER_PERIOD;         
-            }  
-            else
-            {
-                delay_time = 0;
-            }
+/** @brief   The glider's motor drivers and surface potentiometers.
+ *  @details The surface loop reaches the hardware through this class, so the
+ *           simulator can give it a model of the surfaces instead.
+ */
+class BoardSurfaceIO : public SurfaceIO
+{
+protected:
+    DRV8871 motors[SURFACE_AXES];       ///< Motor drivers, in the order of SurfaceAxis
+    Potentiometer pots[SURFACE_AXES];   ///< Potentiometers, in the order of SurfaceAxis
+
+public:
+    /// Set up the motor drivers and potentiometers on their pins
+    BoardSurfaceIO (void)
+        : motors {DRV8871(RUDDER_PIN_IN1, RUDDER_PIN_IN2, RUDDER_CHANNEL_A, RUDDER_CHANNEL_B),
+                  DRV8871(ELEVATOR_PIN_IN1, ELEVATOR_PIN_IN2, ELEVATOR_CHANNEL_A, ELEVATOR_CHANNEL_B)},
+          pots {Potentiometer(RUDDER_POT_PIN, 0), Potentiometer(ELEVATOR_POT_PIN, 0)}
+    { }
+
+    float get_angle (uint8_t axis) { return pots[axis].get_angle(); }
+    void zero (uint8_t axis) { pots[axis].zero(); }
+    void set_duty (uint8_t axis, int16_t duty) { motors[axis].set_duty(duty); }
+};
+
+
+/** @brief   Fast loop which holds the rudder and elevator at their setpoints
+ *  @details Each time a hardware timer fires, at @c SURFACE_LOOP_HZ, this task
+ *           runs the @c SurfaceLoop, which reads the surface potentiometers,
+ *           runs the surface position controllers against the angles in
+ *           @c surface_setpoint and writes the motor duty cycles. It also
+ *           zeroes the potentiometers when the webpage asks for calibration.
+ *           The first time it uses a setpoint calculated from a new IMU
+ *           sample, it records the time from that sample to the motor output
+ *           in @c surface_latency. When the setpoint asks for autotuning, the
+ *           surfaces are tuned one at a time by relay feedback and the
+ *           results are put in @c autotune_result.
+ *  @param   p_params A pointer to this task's @c PeriodicTask object, passed
+ *           by the object's @c start() method
+ */
+void task_surfaces (void* p_params)
+{
+    PeriodicTask* p_task = (PeriodicTask*)p_params;
 
-            // If total delay time has reached 1000 ms...
-            if (delay_time >= 2000) 
-            {
+    Serial << "Surface Task Begin" << endl;
 
-                tc_state.put(2);                // Move to active state
-                delay_time = 0;                 // Reset counter
-            }
+    // Time between runs of the surface loop (ms)
+    const float SURFACE_PERIOD = 1000.0 / SURFACE_LOOP_HZ;
 
-        }
-        else if (tc_state.get() == 2)           // STATE 2: CONTROLLER ACTIVE
-        {
+    BoardSurfaceIO surface_io;      ///< Motor drivers and potentiometers
+    SurfaceLoop surface_loop (SURFACE_PERIOD);
+    surface_loop.begin(surface_io);
 
-            // Time how long the plane is near the ground
-            if (near_ground.get() == 1) 
-            {
-                delay_time += TASK_CONTROLLER_PERIOD;         
-            }  
-            else
-            {
-                delay_time = 0;
-            }
+    SurfaceSetpoint setpoint;       ///< Surface angles wanted by the controller
+    SurfaceState state;             ///< Surface angles and duty cycles now
+    uint32_t last_sample_us = 0;    ///< IMU sample time of the last setpoint used
 
-            // If total delay time has reached 2000 ms...
-            if (delay_time >= 2000) 
-            {
-                tc_state.put(0);                // Move to deactivated state
-                delay_time = 0;                 // Reset counter
-            }
+    GainSet gains;                  ///< Gains sent from the web page
+    uint32_t gains_seen = 0;        ///< Number of gain updates already loaded
 
-            // Check whether the glider is near ground
-            if (near_ground.get()) 
-            {
-                pitchD = 10;                    // If it is, set pitch
-            }
-            else 
-            {
-                pitchD = 0;                     // If not, set different pitch
-            }
+    // Start the timer which wakes this task. Its interrupt is allocated on the
+    // core which calls timerAttachInterrupt(), which is this task's core
+    surface_task_handle = xTaskGetCurrentTaskHandle();
+    hw_timer_t* p_timer = timerBegin(SURFACE_TIMER, 80, true);    // 1 MHz count
+    timerAttachInterrupt(p_timer, &surface_timer_isr, true);
+    timerAlarmWrite(p_timer, 1000000 / SURFACE_LOOP_HZ, true);
+    timerAlarmEnable(p_timer);
 
-            yawD = 0;          
-        
-            // Calculate desired rudder angle and then saturate
-            rudderAngleD = yaw2rudder.getCtrlOutput(yawC.get(),yawD);
-            if (rudderAngleD > rudderAngleMax) 
-            {
-                rudderAngleD = rudderAngleMax;
-            }
-            else if (rudderAngleD < rudderAngleMin) 
-            {
-                rudderAngleD = rudderAngleMin;
-            }
+    while (true)
+    {
+        if (web_calibrate.get()) {        // If the webpage calls for calibration
 
-            // Get current rudder angle
-            rudderAngleC = rudderPot.get_angle();
-            // Check if the difference in rudder angles are less than 30 degrees
-            // to prevent undesired response to flickering measurements
-            if (fabs(rudderAngleC - prev_rudder) < 30)
-            {
-                // Serial.println(fabs(rudderAngleC - prev_rudder));
-                prev_rudder = rudderAngleC;
-                // Calculate desired rudder motor duty cycle, saturate, then put to share
-                rudderDutyD = rudder2duty.getCtrlOutput(rudderAngleC,rudderAngleD);
-                if (rudderDutyD > 100) 
-                {
-                    rudder_duty.put(100);
-                }
-                else if (rudderDutyD < -100) 
-                {
-                    rudder_duty.put(-100);
-                }
-                else
-                {
-                    rudder_duty.put((int16_t) round(rudderDutyD));
-                }
-            }
-            else
+            for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
             {
-                rudder_duty.put(0);
+                surface_io.zero(axis);
             }
-            
 
-            // Calculate desired elevator angle and then saturate
-            elevAngleD = pitch2elev.getCtrlOutput(pitchC.get(),pitchD);
-            if (elevAngleD > elevAngleMax)
-            {
-                elevAngleD = elevAngleMax;
-            }
-            else if (elevAngleD < elevAngleMin)
-            {
-                elevAngleD = elevAngleMin;
-            }
+            web_calibrate.put(0);         // Reset the calibrate flag
 
-            // Get current elevator angle
-            elevAngleC = elevPot.get_angle();
-            if (fabs(elevAngleC - prev_elevator) < 30)
-            {
-                // Calculate desired elevator motor duty cycle, saturate, then put to share
-                elevDutyD = elev2duty.getCtrlOutput(elevAngleC,elevAngleD);
-                if (elevDutyD > 100) 
-                {
-                    elev_duty.put(100);
-                }
-                else if (elevDutyD < -100) 
-                {
-                    elev_duty.put(-100);
-                }
-                else 
-                {
-                    elev_duty.put((int16_t) round(elevDutyD));
-                }
-            }
-            else
-            {
-                elev_duty.put(0);
-            }
+            Serial << "   Calibrated" << endl;
 
-            Serial << "C: " << elevAngleC << "; D: " << elevAngleD << "; Duty: " << elev_duty.get() << endl;
+        }
 
-            prev_elevator = elevAngleC;
-            prev_rudder = rudderAngleC;
+        // Use any gains which the web page has sent since the last iteration
+        if (controller_gains.get_if_updated(gains, gains_seen))
+        {
+            surface_loop.set_gains(gains);
+        }
+
+        surface_setpoint.get(setpoint);
+        if (surface_loop.run(surface_io, setpoint, micros(), state))
+        {
+            autotune_result.put(surface_loop.get_tune_result());
+        }
 
+        // Record the time since the IMU sample behind a new setpoint
+        if (setpoint.sample_us != 0 && setpoint.sample_us != last_sample_us)
+        {
+            surface_latency.record(micros() - setpoint.sample_us);
+            last_sample_us = setpoint.sample_us;
         }
 
-        vTaskDelay(TASK_CONTROLLER_PERIOD);
+        surface_state.put(state);
 
+        p_task->wait_for_notification();
     }
 }
 
-/** @brief   
- *  @details 
- *  @param   p_params A pointer to parameters passed to this task. This 
- *           pointer is ignored; it should be set to @c NULL in the 
- *           call to @c xTaskCreate() which starts this task
- */
-void task_rudder_motor (void* p_params)
-{ 
-
-    // Motor task period
-    const uint8_t period = 50;
+/// Handle of the IMU task, which the LSM6DSOX's INT1 interrupt wakes
+TaskHandle_t IMU_task_handle = NULL;
 
-    Serial << "Rudder Motor Task Begin" << endl;
-    // Create object
-    DRV8871 rudder = DRV8871(RUDDER_PIN_IN1, RUDDER_PIN_IN2, RUDDER_CHANNEL_A, RUDDER_CHANNEL_B);
+/// Low 32 bits of the time at which INT1 last rose (us). A 32-bit time is
+/// written in one instruction, so the task can't read half of an update
+volatile uint32_t imu_int1_us = 0;
 
-    rudder.set_duty(0);
+/// Number of times the LIS3MDL's DRDY line has risen
+volatile uint32_t mag_drdy_count = 0;
 
-    while (true)
-    {
-        // Serial.println(rudder_duty.get());
-        rudder.set_duty(rudder_duty.get());
-        vTaskDelay(period);
-    }
-}   
 
-/** @brief   
- *  @details 
- *  @param   p_params A pointer to parameters passed to this task. This 
- *           pointer is ignored; it should be set to @c NULL in the 
- *           call to @c xTaskCreate() which starts this task
+/** @brief   Interrupt service routine for the LSM6DSOX's INT1 line.
+ *  @details The line rises when the FIFO reaches its watermark, or when a
+ *           sample is ready if the FIFO isn't used. The ISR notes the time,
+ *           which is when the data became ready, and wakes the IMU task.
  */
-void task_elevator_motor (void* p_params)
+void IRAM_ATTR imu_int1_isr (void)
 {
-    
-    // Motor task period
-    const uint8_t period = 50;
-
-    Serial << "Elevator Motor Task Begin" << endl;
-    // Create object
-    DRV8871 elevator = DRV8871(
-        ELEVATOR_PIN_IN1, ELEVATOR_PIN_IN2, ELEVATOR_CHANNEL_A, ELEVATOR_CHANNEL_B);
+    imu_int1_us = (uint32_t)esp_timer_get_time ();
+    BaseType_t wake_up = pdFALSE;
+    vTaskNotifyGiveFromISR (IMU_task_handle, &wake_up);
+    portYIELD_FROM_ISR (wake_up);
+}
 
-    elevator.set_duty(0);
 
-    while (true)
-    {
-      elevator.set_duty(elev_duty.get());
-      vTaskDelay(period);
-    }
+/** @brief   Interrupt service routine for the LIS3MDL's DRDY line.
+ *  @details The magnetometer only corrects the heading, so it doesn't wake
+ *           the IMU task; the count tells the task to read it on its next
+ *           pass. A count rather than a flag can't lose a rise which comes
+ *           while the task is clearing the flag.
+ */
+void IRAM_ATTR mag_drdy_isr (void)
+{
+    mag_drdy_count++;
 }
 
+
 /** @brief   Task function to interface with IMU
- *  @details This task reads from the IMU to get pitch, yaw, and roll
- *           measurements. It then puts the data into shaes for the 
- *           controller to use. 
- *  @param   p_params A pointer to parameters passed to this task. This 
- *           pointer is ignored; it should be set to @c NULL in the 
- *           call to @c xTaskCreate() which starts this task
+ *  @details This task reads the IMU and runs the readings through an
+ *           attitude filter to get pitch, yaw, and roll. It then puts the
+ *           angles, together with the gyro rates, the time of the reading
+ *           and a sequence number, into one share for the controller to
+ *           use. The sensors sample at @c IMU_FIFO_RATE into their FIFO, and
+ *           each pass, every @c IMU_PERIOD, filters all the samples taken
+ *           since the last one; if the FIFO is turned off with
+ *           @c IMU_USE_FIFO, the data rate matches the task's period
+ *           instead. A pass which finds no new sample publishes nothing, so
+ *           the controller never sees a repeat.
+ *
+ *           If @c IMU_INTERRUPTS is true, the task sleeps until the
+ *           LSM6DSOX's INT1 line says the FIFO has reached its watermark or a
+ *           sample is ready, and the time the line rose is used as the time
+ *           of that sample. The magnetometer is read only after its DRDY
+ *           line has risen. If INT1 stays quiet for two periods the task
+ *           reads anyway, so an unwired or stuck line only slows it down.
+ *  @param   p_params A pointer to this task's @c PeriodicTask object, passed
+ *           by the object's @c start() method
  */
 void task_IMU(void* p_params) 
 {
     // INIT
-    LSM6DSOX imu;
+    LSM6DSOX imu (1000 / IMU_PERIOD);
     // declare float
     float pitch, yaw, roll;
+    float pitch_rate, yaw_rate, roll_rate;
+
+    PeriodicTask* p_task = (PeriodicTask*)p_params;
+
+    // The interrupts are attached from this task, so they run on its core
+    // and may wake it. A line which is already high when its interrupt is
+    // attached has no rising edge, so the first pass reads both sensors
+    // regardless, which lowers the lines
+    uint32_t int1_us = 0;               // Time INT1 rose, or 0 if it didn't
+    uint32_t mag_count_seen = mag_drdy_count - 1;
+    if (IMU_INTERRUPTS)
+    {
+        IMU_task_handle = xTaskGetCurrentTaskHandle();
+        pinMode(IMU_INT1_PIN, INPUT_PULLDOWN);
+        pinMode(MAG_DRDY_PIN, INPUT_PULLDOWN);
+        imu.route_int1();
+        attachInterrupt(digitalPinToInterrupt(IMU_INT1_PIN), imu_int1_isr, RISING);
+        attachInterrupt(digitalPinToInterrupt(MAG_DRDY_PIN), mag_drdy_isr, RISING);
+    }
+
+    // Sample published to the controller
+    AttitudeSample sample;
+    sample.sequence = 0;
+
+    MahonyGains gains;                  // Filter gains sent from the web page
+    uint32_t gains_seen = 0;            // Number of gain updates already loaded
 
     // READ VALUES
     while(true)
     {
+        // Use any filter gains which the web page has sent
+        if (filter_gains.get_if_updated(gains, gains_seen))
+        {
+            imu.set_gains(gains.kp, gains.ki);
+        }
 
-        // SEND IT AND THE DATA BACK IN RADIANS
-        imu.get_angle((float)time(0), pitch, yaw, roll);
+        // Read the magnetometer only if it has new data
+        uint32_t mag_count = mag_drdy_count;
+        bool mag_ready = !IMU_INTERRUPTS || mag_count != mag_count_seen;
+        mag_count_seen = mag_count;
 
-        // Serial << "P: " << pitch*180/M_PI << ";  R: " << roll*180/M_PI << endl;
+        // Read and filter, noting the time the sample is taken for the
+        // filter's time step and for measuring latency
+        imu.update(int1_us, mag_ready);
+        if (imu.get_batch_size() > 0)
+        {
+            imu_read_time.record(imu.get_sample_read_us());
+        }
 
-        // PUT ANGLES TO SHARES FOR CONTROLLER
-        pitchC.put(pitch*180/M_PI);
-        yawC.put(roll*180/M_PI);
+        // Publish the bus figures which go with the read times
+        IMUStatus status;
+        status.bus_clock = imu.get_bus_clock();
+        status.raw_failures = imu.get_raw_failures();
+        status.fifo_overruns = imu.get_fifo_overruns();
+        status.batch_size = imu.get_batch_size();
+        imu_status.put(status);
 
-        // PRINT IT
-        // Serial << pitch * 180/M_PI << ", " << yaw * 180/M_PI << ", " << roll * 180/M_PI << endl;
-        
-        vTaskDelay(1);
+        // SEND IT AND THE DATA BACK IN RADIANS, unless nothing was new
+        if (imu.get_batch_size() > 0)
+        {
+            sample.time_us = imu.get_time_us();
+            imu.get_angle(pitch, yaw, roll);
+            imu.get_rates(pitch_rate, yaw_rate, roll_rate);
+
+            // Serial << "P: " << pitch*180/M_PI << ";  R: " << roll*180/M_PI << endl;
+
+            // PUT ANGLES TO ONE SHARE FOR CONTROLLER
+            sample.sequence++;
+            sample.pitch = pitch*DEG_PER_RAD;
+            sample.roll = roll*DEG_PER_RAD;
+            sample.yaw = yaw*DEG_PER_RAD;
+            sample.pitch_rate = pitch_rate*DEG_PER_RAD;
+            sample.roll_rate = roll_rate*DEG_PER_RAD;
+            sample.yaw_rate = yaw_rate*DEG_PER_RAD;
+            attitude.put(sample);
+        }
+
+        // Sleep until INT1 says there's new data, or for one period
+        if (IMU_INTERRUPTS)
+        {
+            int1_us = p_task->wait_for_notification() ? imu_int1_us : 0;
+        }
+        else
+        {
+            p_task->wait_for_next_period();
+        }
     }
 }
 
 
+// Task stacks, sized in bytes. They are allocated when the program is compiled
+// so that the linker's RAM report includes them; print_all_tasks() shows how
+// much of each one has actually been used
+StackType_t webserver_stack[8192];          ///< Stack for the web server task
+StackType_t surface_stack[2048];            ///< Stack for the surface loop task
+StackType_t ultrasonic_stack[2048];         ///< Stack for the ultrasonic task
+StackType_t controller_stack[4096];         ///< Stack for the controller task
+StackType_t IMU_stack[2048];                ///< Stack for the IMU task
+
+// Task priorities. FreeRTOS on the ESP32 has priorities 0 to
+// configMAX_PRIORITIES - 1 (24) and quietly lowers any higher value to 24, so
+// the order below only holds if every value is in range. Priority 24 itself
+// is left to ESP-IDF's IPC task on each core, which would otherwise share
+// time slices with the surface loop. Along the path from IMU sample to
+// motor, each flight task has a strictly higher priority than the one before
+// it, so each stage preempts the previous one as soon as that stage has
+// published its output. The WiFi stack runs at 23 on core 0
+const UBaseType_t SURFACE_PRIORITY = 23;        ///< Surface loop, core 1
+const UBaseType_t CONTROLLER_PRIORITY = 22;     ///< Attitude loop, core 1
+const UBaseType_t IMU_PRIORITY = 21;            ///< IMU readings, core 1
+const UBaseType_t ULTRASONIC_PRIORITY = 5;      ///< Ultrasonic sensor, core 0
+const UBaseType_t WEBSERVER_PRIORITY = 4;       ///< Web server, core 0
+
+static_assert (SURFACE_PRIORITY < configMAX_PRIORITIES - 1
+               && CONTROLLER_PRIORITY < configMAX_PRIORITIES - 1
+               && IMU_PRIORITY < configMAX_PRIORITIES - 1
+               && ULTRASONIC_PRIORITY < configMAX_PRIORITIES - 1
+               && WEBSERVER_PRIORITY < configMAX_PRIORITIES - 1,
+               "Task priorities must be in range and below the IPC task's");
+static_assert (SURFACE_PRIORITY > CONTROLLER_PRIORITY
+               && CONTROLLER_PRIORITY > IMU_PRIORITY,
+               "Each flight task must outrank the one which feeds it");
+
+// Tasks, with their priorities, periods (ms) and cores. The web server runs at a
+// low priority on core 0 with the WiFi stack; the flight tasks share core 1.
+// The ultrasonic task also runs on core 0, because pulseIn() busy-waits for
+// the echo for up to 25 ms and would otherwise take that time from the
+// flight tasks. The surface loop is woken by a hardware timer; its period is
+// only used to check that each pass finishes in time
+PeriodicTask webserver_task ("Web Server", task_webserver, webserver_stack, WEBSERVER_PRIORITY, 500, 0);
+PeriodicTask surface_task ("Surface Loop", task_surfaces, surface_stack, SURFACE_PRIORITY, 1000 / SURFACE_LOOP_HZ, 1);
+PeriodicTask ultrasonic_task ("Ultrasonic Sensor", task_ultrasonic, ultrasonic_stack, ULTRASONIC_PRIORITY, 100, 0);
+PeriodicTask controller_task ("Flight Controls", task_controller, controller_stack, CONTROLLER_PRIORITY, ATTITUDE_PERIOD, 1);
+PeriodicTask IMU_task ("IMU", task_IMU, IMU_stack, IMU_PRIORITY, IMU_PERIOD, 1);
+
+/// Time between printouts of the task stack and timing table (ms)
+const uint32_t TASK_REPORT_PERIOD = 10000;
+
+
 /** @brief   The Arduino setup function.
  *  @details This function is used to set up the microcontroller by starting
  *           the serial port and creating the tasks.
@@ -433,23 +631,13 @@ void setup (void)
     // Initialize web_calibrate to zero
     web_calibrate.put(1);
 
-    // Task which runs the web server. It runs at a low priority
-    xTaskCreate (task_webserver, "Web Server", 8192, NULL, 10, NULL);
-
-    // Task for the potentiometer testing
-    xTaskCreate (task_rudder_motor, "Rudder Motor", 2048, NULL, 20, NULL);
-
-    // Task for the potentiometer testing
-    xTaskCreate (task_elevator_motor, "Elevator Motor", 2048, NULL, 40, NULL);
-    
-    // Task for the ultrasonic sensor
-    xTaskCreate (task_ultrasonic, "Ultrasonic Sensor", 2048, NULL, 50, NULL);
-
-    // Task for the flight surface controls (rudder and elevator)
-    xTaskCreate (task_controller, "Flight Controls", 2048,  NULL, 60, NULL);
-
-    // Task for the IMU readings
-    xTaskCreate (task_IMU, "IMU", 2048, NULL, 30, NULL);
+    // Start the tasks. Their stacks were allocated when the program was
+    // compiled, so no heap memory is needed for them
+    webserver_task.start ();
+    surface_task.start ();
+    ultrasonic_task.start ();
+    controller_task.start ();
+    IMU_task.start ();
 }
 
 
@@ -457,8 +645,26 @@ void setup (void)
  *  @details This function is called periodically by the Arduino system. It
  *           runs as a low priority task. On some microcontrollers it will
  *           crash when FreeRTOS is running, so we usually don't use this
- *           function for anything. 
+ *           function for anything except printing, every few seconds, each
+ *           task's stack use and timing, the sensor to motor latencies,
+ *           the IMU's read times, with its bus figures beside them, and,
+ *           while the controller is active, the elevator's angle, desired
+ *           angle and duty cycle.
  */
 void loop (void)
 {
-}
\ No newline at end of file
+    vTaskDelay (TASK_REPORT_PERIOD);
+    print_all_tasks (Serial);
+    print_all_histograms (Serial);
+    print_imu_status (imu_status.get (), Serial);
+    print_transitions (state_transitions.get (), Serial);
+
+    if (tc_state.get () == STATE_ACTIVE)
+    {
+        SurfaceState surfaces = surface_state.get ();
+        Serial << "C: " << surfaces.angle[ELEVATOR_AXIS]
+               << "; D: " << surface_setpoint.get ().angle[ELEVATOR_AXIS]
+               << "; Duty: " << surfaces.duty[ELEVATOR_AXIS]
+               << "; Stale: " << stale_samples.get () << endl;
+    }
+}
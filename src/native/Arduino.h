@@ -0,0 +1,138 @@
+/** @file    Arduino.h
+ *  @brief   Minimal stand-in for the Arduino and FreeRTOS headers on a host PC.
+ *  @details The @c native PlatformIO environments build parts of this project
+ *           for the computer running PlatformIO rather than for the ESP32, so
+ *           that shares and control code can be benchmarked and simulated.
+ *           This header supplies just the pieces of the Arduino core and the
+ *           FreeRTOS API which those parts use. Queues are emulated with a
+ *           mutex and a condition variable, which costs about what a kernel
+ *           critical section costs on the ESP32, and each host thread counts
+ *           as one task.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Added @c PI for the simulator
+ */
+
+#ifndef _NATIVE_ARDUINO_H_
+#define _NATIVE_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef NATIVE
+    #define NATIVE
+#endif
+
+
+// ---------------------------------------------------------------------------
+// Arduino core
+
+/** @brief   Host version of the Arduino @c Print class.
+ *  @details Descendents override @c write() to send one character somewhere;
+ *           everything else is built on top of that.
+ */
+class Print
+{
+public:
+    virtual ~Print (void) { }
+
+    /// Send one character to the output device
+    virtual size_t write (uint8_t ch) = 0;
+
+    size_t write (const char* str);
+    size_t printf (const char* format, ...);
+    size_t print (const char* str) { return write (str); }
+    size_t print (char ch) { return write ((uint8_t)ch); }
+    size_t print (long number);
+    size_t print (unsigned long number);
+    size_t print (int number) { return print ((long)number); }
+    size_t print (unsigned int number) { return print ((unsigned long)number); }
+    size_t print (double number, int digits = 2);
+    size_t println (void) { return write ("\r\n"); }
+    template <class T> size_t println (T thing)
+    {
+        return print (thing) + println ();
+    }
+};
+
+/// @brief A @c Print device which writes to the standard output
+class HostSerial : public Print
+{
+public:
+    void begin (unsigned long) { }
+    operator bool (void) { return true; }
+    size_t write (uint8_t ch) { return fputc (ch, stdout) == EOF ? 0 : 1; }
+    using Print::write;
+};
+
+extern HostSerial Serial;               ///< Standard output, as @c Serial
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+uint32_t micros (void);                 ///< Microseconds since the program began
+uint32_t millis (void);                 ///< Milliseconds since the program began
+void delay (uint32_t ms);               ///< Sleep the calling thread
+
+
+// ---------------------------------------------------------------------------
+// FreeRTOS
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint8_t StackType_t;
+#define portBASE_TYPE int
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFF)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define errQUEUE_FULL 0
+
+struct NativeQueue;
+typedef NativeQueue* QueueHandle_t;     ///< Handle of an emulated queue
+
+/// @brief Storage for a queue's control block, as in @c xQueueCreateStatic()
+typedef struct { void* p_dummy[8]; } StaticQueue_t;
+
+QueueHandle_t xQueueCreate (UBaseType_t length, UBaseType_t item_size);
+QueueHandle_t xQueueCreateStatic (UBaseType_t length, UBaseType_t item_size,
+                                  uint8_t* p_storage, StaticQueue_t* p_block);
+BaseType_t xQueueSendToBack (QueueHandle_t queue, const void* p_item,
+                             TickType_t wait);
+BaseType_t xQueueSendToFront (QueueHandle_t queue, const void* p_item,
+                              TickType_t wait);
+BaseType_t xQueueOverwrite (QueueHandle_t queue, const void* p_item);
+BaseType_t xQueueReceive (QueueHandle_t queue, void* p_item, TickType_t wait);
+BaseType_t xQueuePeek (QueueHandle_t queue, void* p_item, TickType_t wait);
+UBaseType_t uxQueueMessagesWaiting (QueueHandle_t queue);
+
+// There are no interrupts on the host, so the ISR versions just don't wait
+#define xQueueSendToBackFromISR(q, p, w) xQueueSendToBack (q, p, 0)
+#define xQueueSendToFrontFromISR(q, p, w) xQueueSendToFront (q, p, 0)
+#define xQueueOverwriteFromISR(q, p, w) xQueueOverwrite (q, p)
+#define xQueueReceiveFromISR(q, p, w) xQueueReceive (q, p, 0)
+#define xQueuePeekFromISR(q, p) xQueuePeek (q, p, 0)
+#define uxQueueMessagesWaitingFromISR(q) uxQueueMessagesWaiting (q)
+
+TickType_t xTaskGetTickCount (void);    ///< Milliseconds since the program began
+void vTaskDelay (TickType_t ticks);     ///< Sleep the calling thread
+
+struct NativeTask;
+typedef NativeTask* TaskHandle_t;       ///< Each host thread is one task
+
+TaskHandle_t xTaskGetCurrentTaskHandle (void);
+uint32_t ulTaskNotifyTake (BaseType_t clear, TickType_t wait);
+BaseType_t xTaskNotifyGive (TaskHandle_t task);
+#define vTaskNotifyGiveFromISR(t, w) xTaskNotifyGive (t)
+#define portYIELD_FROM_ISR(w) (void)(w)
+
+#endif // _NATIVE_ARDUINO_H_
@@ -0,0 +1,72 @@
+/** @file    PrintStream.h
+ *  @brief   Host version of the @c << operators from the PrintStream library.
+ *  @details The ESP32 build gets these operators from the Arduino-PrintStream
+ *           library; the @c native builds use this much smaller version.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#ifndef _NATIVE_PRINTSTREAM_H_
+#define _NATIVE_PRINTSTREAM_H_
+
+#include <Arduino.h>
+
+/// @brief Manipulator which ends a line, as in the PrintStream library
+enum PrintStreamEndl { endl };
+
+inline Print& operator << (Print& printer, PrintStreamEndl)
+{
+    printer.println ();
+    return printer;
+}
+
+inline Print& operator << (Print& printer, const char* str)
+{
+    printer.print (str);
+    return printer;
+}
+
+inline Print& operator << (Print& printer, char ch)
+{
+    printer.print (ch);
+    return printer;
+}
+
+inline Print& operator << (Print& printer, bool value)
+{
+    printer.print (value ? "true" : "false");
+    return printer;
+}
+
+inline Print& operator << (Print& printer, int number)
+{
+    printer.print ((long)number);
+    return printer;
+}
+
+inline Print& operator << (Print& printer, long number)
+{
+    printer.print (number);
+    return printer;
+}
+
+inline Print& operator << (Print& printer, unsigned int number)
+{
+    printer.print ((unsigned long)number);
+    return printer;
+}
+
+inline Print& operator << (Print& printer, unsigned long number)
+{
+    printer.print (number);
+    return printer;
+}
+
+inline Print& operator << (Print& printer, double number)
+{
+    printer.print (number);
+    return printer;
+}
+
+#endif // _NATIVE_PRINTSTREAM_H_
@@ -0,0 +1,295 @@
+/** @file    native_rtos.cpp
+ *  @brief   Host implementation of the Arduino and FreeRTOS pieces declared
+ *           in the @c native version of @c Arduino.h.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+
+HostSerial Serial;
+
+
+/** @brief   Write a C string one character at a time.
+ *  @param   str The string to be written
+ *  @returns The number of characters written
+ */
+size_t Print::write (const char* str)
+{
+    size_t count = 0;
+    while (*str)
+    {
+        count += write ((uint8_t)*str++);
+    }
+    return count;
+}
+
+
+/** @brief   Format and print, as does the ESP32 core's @c Print::printf().
+ *  @param   format A @c printf() style format string
+ *  @returns The number of characters written
+ */
+size_t Print::printf (const char* format, ...)
+{
+    char buffer[256];
+    va_list args;
+    va_start (args, format);
+    vsnprintf (buffer, sizeof (buffer), format, args);
+    va_end (args);
+    return write (buffer);
+}
+
+
+/** @brief   Print a signed integer in decimal.
+ *  @param   number The number to be printed
+ *  @returns The number of characters written
+ */
+size_t Print::print (long number)
+{
+    return printf ("%ld", number);
+}
+
+
+/** @brief   Print an unsigned integer in decimal.
+ *  @param   number The number to be printed
+ *  @returns The number of characters written
+ */
+size_t Print::print (unsigned long number)
+{
+    return printf ("%lu", number);
+}
+
+
+/** @brief   Print a floating point number.
+ *  @param   number The number to be printed
+ *  @param   digits How many digits to show after the decimal point
+ *  @returns The number of characters written
+ */
+size_t Print::print (double number, int digits)
+{
+    return printf ("%.*f", digits, number);
+}
+
+
+/// The time at which the program began, for @c micros() and @c millis()
+static const std::chrono::steady_clock::time_point start_time
+    = std::chrono::steady_clock::now ();
+
+
+uint32_t micros (void)
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds> (
+        std::chrono::steady_clock::now () - start_time).count ();
+}
+
+
+uint32_t millis (void)
+{
+    return micros () / 1000;
+}
+
+
+void delay (uint32_t ms)
+{
+    std::this_thread::sleep_for (std::chrono::milliseconds (ms));
+}
+
+
+TickType_t xTaskGetTickCount (void)
+{
+    return millis ();
+}
+
+
+void vTaskDelay (TickType_t ticks)
+{
+    delay (ticks);
+}
+
+
+/** @brief   An emulated FreeRTOS queue.
+ *  @details Items are kept in a ring of bytes protected by a mutex. Tasks
+ *           which must wait for space or for data wait on a condition
+ *           variable, with timeouts measured in milliseconds as if the RTOS
+ *           tick were 1 ms as it is on the ESP32.
+ */
+struct NativeQueue
+{
+    std::mutex mutex;                   ///< Protects everything below
+    std::condition_variable changed;    ///< Signalled when items come or go
+    std::vector<uint8_t> storage;       ///< Ring buffer of items
+    UBaseType_t length;                 ///< Maximum number of items
+    UBaseType_t item_size;              ///< Size of each item in bytes
+    UBaseType_t head;                   ///< Index of the oldest item
+    UBaseType_t count;                  ///< Number of items in the ring
+
+    NativeQueue (UBaseType_t a_length, UBaseType_t an_item_size)
+        : storage (a_length * an_item_size), length (a_length),
+          item_size (an_item_size), head (0), count (0)
+    {
+    }
+
+    uint8_t* slot (UBaseType_t index)
+    {
+        return &storage[((head + index) % length) * item_size];
+    }
+
+    /// Wait until @c ready() is true or the timeout expires
+    template <class Predicate>
+    bool wait (std::unique_lock<std::mutex>& lock, TickType_t ticks,
+               Predicate ready)
+    {
+        if (ticks == portMAX_DELAY)
+        {
+            changed.wait (lock, ready);
+            return true;
+        }
+        return changed.wait_for (lock, std::chrono::milliseconds (ticks),
+                                 ready);
+    }
+};
+
+
+QueueHandle_t xQueueCreate (UBaseType_t length, UBaseType_t item_size)
+{
+    return new NativeQueue (length, item_size);
+}
+
+
+QueueHandle_t xQueueCreateStatic (UBaseType_t length, UBaseType_t item_size,
+                                  uint8_t*, StaticQueue_t*)
+{
+    return new NativeQueue (length, item_size);
+}
+
+
+BaseType_t xQueueSendToBack (QueueHandle_t queue, const void* p_item,
+                             TickType_t wait)
+{
+    std::unique_lock<std::mutex> lock (queue->mutex);
+    if (!queue->wait (lock, wait, [queue] { return queue->count < queue->length; }))
+    {
+        return errQUEUE_FULL;
+    }
+    memcpy (queue->slot (queue->count), p_item, queue->item_size);
+    queue->count++;
+    queue->changed.notify_all ();
+    return pdTRUE;
+}
+
+
+BaseType_t xQueueSendToFront (QueueHandle_t queue, const void* p_item,
+                              TickType_t wait)
+{
+    std::unique_lock<std::mutex> lock (queue->mutex);
+    if (!queue->wait (lock, wait, [queue] { return queue->count < queue->length; }))
+    {
+        return errQUEUE_FULL;
+    }
+    queue->head = (queue->head + queue->length - 1) % queue->length;
+    memcpy (queue->slot (0), p_item, queue->item_size);
+    queue->count++;
+    queue->changed.notify_all ();
+    return pdTRUE;
+}
+
+
+BaseType_t xQueueOverwrite (QueueHandle_t queue, const void* p_item)
+{
+    std::lock_guard<std::mutex> lock (queue->mutex);
+    queue->head = 0;
+    queue->count = 1;
+    memcpy (queue->slot (0), p_item, queue->item_size);
+    queue->changed.notify_all ();
+    return pdTRUE;
+}
+
+
+BaseType_t xQueueReceive (QueueHandle_t queue, void* p_item, TickType_t wait)
+{
+    std::unique_lock<std::mutex> lock (queue->mutex);
+    if (!queue->wait (lock, wait, [queue] { return queue->count > 0; }))
+    {
+        return pdFALSE;
+    }
+    memcpy (p_item, queue->slot (0), queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    queue->changed.notify_all ();
+    return pdTRUE;
+}
+
+
+BaseType_t xQueuePeek (QueueHandle_t queue, void* p_item, TickType_t wait)
+{
+    std::unique_lock<std::mutex> lock (queue->mutex);
+    if (!queue->wait (lock, wait, [queue] { return queue->count > 0; }))
+    {
+        return pdFALSE;
+    }
+    memcpy (p_item, queue->slot (0), queue->item_size);
+    return pdTRUE;
+}
+
+
+UBaseType_t uxQueueMessagesWaiting (QueueHandle_t queue)
+{
+    std::lock_guard<std::mutex> lock (queue->mutex);
+    return queue->count;
+}
+
+
+/** @brief   An emulated task, holding the notification count of one thread.
+ */
+struct NativeTask
+{
+    std::mutex mutex;                   ///< Protects the count
+    std::condition_variable given;      ///< Signalled when the count goes up
+    uint32_t count = 0;                 ///< The notification value
+};
+
+
+TaskHandle_t xTaskGetCurrentTaskHandle (void)
+{
+    static thread_local NativeTask this_task;
+    return &this_task;
+}
+
+
+uint32_t ulTaskNotifyTake (BaseType_t clear, TickType_t wait)
+{
+    NativeTask* p_task = xTaskGetCurrentTaskHandle ();
+    std::unique_lock<std::mutex> lock (p_task->mutex);
+    auto ready = [p_task] { return p_task->count > 0; };
+    if (wait == portMAX_DELAY)
+    {
+        p_task->given.wait (lock, ready);
+    }
+    else
+    {
+        p_task->given.wait_for (lock, std::chrono::milliseconds (wait), ready);
+    }
+
+    uint32_t value = p_task->count;
+    if (value > 0)
+    {
+        p_task->count = clear ? 0 : value - 1;
+    }
+    return value;
+}
+
+
+BaseType_t xTaskNotifyGive (TaskHandle_t task)
+{
+    std::lock_guard<std::mutex> lock (task->mutex);
+    task->count++;
+    task->given.notify_all ();
+    return pdPASS;
+}
@@ -12,6 +12,17 @@
  *  @date   2022-Mar-28 Original stuff by Sinha
  *  @date   2022-Nov-04 Modified for ME507 use by Ridgely
  *  @date   2022-Nov-29 Modified for Airheads Glider Project use by Li
+ *  @date   2026-Oct-16 Web server task runs as a @c PeriodicTask
+ *  @date   2026-Oct-16 Added @c /stats page with task timing as JSON
+ *  @date   2026-Oct-16 Added sensor to motor latencies to @c /stats
+ *  @date   2026-Oct-16 Added @c /gains pages which change controller gains
+ *  @date   2026-Oct-16 Added @c /schedule pages which change gain schedules
+ *  @date   2026-Oct-16 Added surface loop autotuning; gains kept in flash
+ *  @date   2026-Oct-16 Added @c /filter pages which change the attitude
+ *                      filter's gains
+ *  @date   2026-Oct-16 Added @c /transitions page with the controller's state changes
+ *  @date   2026-Oct-16 Gains saved only by @c /gains/save and after an
+ *                      autotune, and only while the controller is disabled
  *  @copyright 2022 by the authors, released under the MIT License.
  */
 
@@ -21,9 +32,39 @@
 #include <WebServer.h>
 #include <shares.h>
 #include <taskshare.h>
+#include "periodictask.h"
+#include "profiler.h"
+#include "gainstore.h"
 
 Share<bool> web_calibrate ("Flag to calibrate/zero");       ///< A share containing a boolean flagging the main script to zero the potentiometers
 
+/// The gains most recently sent to the control loops. Only the web server
+/// task changes them, so it is the single writer of @c controller_gains
+GainSet web_gains = DEFAULT_GAINS;
+
+/// The gain schedules most recently sent to the attitude loop
+ScheduleSet web_schedules = DEFAULT_SCHEDULES;
+
+/// The attitude filter gains most recently sent to the IMU task
+MahonyGains web_filter_gains = DEFAULT_MAHONY_GAINS;
+
+/** @brief   The controllers whose gains can be set from the web page.
+ *  @details Each has the name by which it is chosen in a request and the
+ *           loop and axis of its gains in a @c GainSet.
+ */
+const struct
+{
+    const char* name;                   ///< Name of the controller
+    bool surface_loop;                  ///< In the surface loop, not attitude
+    SurfaceAxis axis;                   ///< The surface which it moves
+} gain_controllers[] =
+{
+    {"yaw2rudder", false, RUDDER_AXIS},
+    {"pitch2elev", false, ELEVATOR_AXIS},
+    {"rudder2duty", true, RUDDER_AXIS},
+    {"elev2duty", true, ELEVATOR_AXIS}
+};
+
 // #define USE_LAN to have the ESP32 join an existing Local Area Network or 
 // #undef USE_LAN to have the ESP32 act as an access point, forming its own LAN
 #undef USE_LAN
@@ -59,6 +100,33 @@ IPAddress subnet (255, 255, 255, 0);        ///< Network mask; just leave this a
 WebServer server (80);
 
 
+/** @brief   A @c Print device which appends everything printed to a string.
+ *  @details This lets functions which print diagnostic tables to the serial
+ *           port, such as @c print_all_shares(), also fill in a web page.
+ */
+class StringPrinter : public Print
+{
+protected:
+    String& text;                       ///< The string being printed into
+
+public:
+    /** @brief   Create a printer which appends to the given string.
+     *  @param   a_string The string to which printed characters are added
+     */
+    StringPrinter (String& a_string) : text (a_string) { }
+
+    /** @brief   Append one character to the string.
+     *  @param   ch The character to be added
+     *  @returns The number of characters written, which is always 1
+     */
+    size_t write (uint8_t ch)
+    {
+        text += (char)ch;
+        return 1;
+    }
+};
+
+
 /** @brief   Get the WiFi running so we can serve some web pages.
  */
 void setup_wifi (void)
@@ -152,6 +220,9 @@ void handle_DocumentRoot ()
                             <form action="/calibrate">
                                 <input type="submit" value="Calibrate/Zero">
                             </form>
+                            <form action="/autotune">
+                                <input type="submit" value="Autotune Surfaces">
+                            </form>
                         </tr>
                     </table>
                     <h2>
@@ -167,19 +238,38 @@ void handle_DocumentRoot ()
                         <input type="submit" value="Set Elevator (-90, 90)" style="width:250x;height:50px;font-size:20px;">
                     </form>
                     <br>
-                    <form action="/">
-                        <input type="text" style="width:150px;height:50px;font-size:20px;">
+                    <form action="/gains/set">
+                        <input type="hidden" name="controller" value="yaw2rudder">
+                        <input type="text" name="kp" placeholder="Kp" style="width:100px;height:50px;font-size:20px;">
+                        <input type="text" name="ki" placeholder="Ki" style="width:100px;height:50px;font-size:20px;">
+                        <input type="text" name="kd" placeholder="Kd" style="width:100px;height:50px;font-size:20px;">
                         <input type="submit" value="Set Rudder Gain" style="width:250x;height:50px;font-size:20px;">
                     </form>
                     <br>
-                    <form action="/">
-                        <input type="text" style="width:150px;height:50px;font-size:20px;">
+                    <form action="/gains/set">
+                        <input type="hidden" name="controller" value="pitch2elev">
+                        <input type="text" name="kp" placeholder="Kp" style="width:100px;height:50px;font-size:20px;">
+                        <input type="text" name="ki" placeholder="Ki" style="width:100px;height:50px;font-size:20px;">
+                        <input type="text" name="kd" placeholder="Kd" style="width:100px;height:50px;font-size:20px;">
                         <input type="submit" value="Set Elevator Gain" style="width:250x;height:50px;font-size:20px;">
                     </form>
                     <br>
-                    <form action="/">
+                    <form action="/gains/reset">
                         <input type="submit" value="Reset Default Gain" style="width:250x;height:50px;font-size:20px;">
                     </form>
+                    <form action="/gains/save">
+                        <input type="submit" value="Save Gains" style="width:250x;height:50px;font-size:20px;">
+                    </form>
+                    <form action="/filter/set">
+                        <input type="text" name="kp" placeholder="Kp" style="width:100px;height:50px;font-size:20px;">
+                        <input type="text" name="ki" placeholder="Ki" style="width:100px;height:50px;font-size:20px;">
+                        <input type="submit" value="Set Attitude Filter Gain" style="width:250x;height:50px;font-size:20px;">
+                    </form>
+                    <br>
+                    <p><a href="/gains">Current gains</a>
+                       <a href="/filter">Filter gains</a>
+                       <a href="/schedule">Gain schedules</a>
+                       <a href="/transitions">State changes</a></p>
                 </div>
             </main>
         </body>
@@ -255,15 +345,485 @@ void handle_Calibrate (void)
 }
 
 
+/** @brief   Switches the controller FSM to autotune the surface loops.
+ *  @details The surface loop swings each surface in turn to find its gains,
+ *           which takes a few seconds, then the controller returns to state
+ *           0. The web server task then saves the new gains. The surfaces
+ *           should be calibrated and free to move before this is done, so
+ *           the request is refused with error 409 unless the controller is
+ *           disabled.
+ */
+void handle_Autotune (void)
+{
+    if (tc_state.get () != STATE_DISABLED)
+    {
+        server.send (409, "text/plain", "Deactivate flight control first");
+        return;
+    }
+    tc_state.put(STATE_AUTOTUNE);
+
+    String toggle_page = "<!DOCTYPE html> <html> <head>\n";
+    toggle_page += "<meta http-equiv=\"refresh\" content=\"5; url='/gains'\" />\n";
+    toggle_page += "</head> <body> <p> Autotuning... <a href='/gains'>New gains</a></p>";
+    toggle_page += "</body> </html>";
+
+    server.send (200, "text/html", toggle_page); 
+}
+
+
+/** @brief   Sends a table of all shares and queues with their statistics.
+ *  @details The table is the same one printed by @c print_all_shares(), sent
+ *           as plain text so it lines up in a browser. A copy is also printed
+ *           on the serial port.
+ */
+void handle_Shares (void)
+{
+    String table;
+    StringPrinter printer (table);
+    print_all_shares (printer);
+
+    Serial << table;
+    server.send (200, "text/plain", table);
+}
+
+
+/** @brief   Sends the stack use and timing statistics of all tasks as JSON.
+ *  @details The JSON object has the output of @c print_all_tasks_json() as
+ *           @c "system", that of @c print_all_histograms_json(), such as
+ *           sensor to motor latencies and IMU read times, as @c "latency",
+ *           and the IMU's bus figures from @c print_imu_status_json() as
+ *           @c "imu". The same figures are printed on the serial port.
+ */
+void handle_Stats (void)
+{
+    String json;
+    json.reserve (2048);
+    StringPrinter printer (json);
+    printer.print ("{\"system\":");
+    print_all_tasks_json (printer);
+    printer.print (",\"latency\":");
+    print_all_histograms_json (printer);
+    IMUStatus status = imu_status.get ();
+    printer.print (",\"imu\":");
+    print_imu_status_json (status, printer);
+    printer.print ("}");
+
+    print_all_tasks (Serial);
+    print_all_histograms (Serial);
+    print_imu_status (status, Serial);
+    server.send (200, "application/json", json);
+}
+
+
+/** @brief   Sends the controller's recent changes of state as JSON.
+ *  @details The JSON is made by @c print_transitions_json(). A table of the
+ *           same changes is also printed on the serial port.
+ */
+void handle_Transitions (void)
+{
+    TransitionLog log;
+    state_transitions.get (log);
+
+    String json;
+    StringPrinter printer (json);
+    print_transitions_json (log, printer);
+
+    print_transitions (log, Serial);
+    server.send (200, "application/json", json);
+}
+
+
+/** @brief   Sends the gains of every controller as JSON.
+ *  @details The JSON object has one member for each controller, named as in
+ *           @c gain_controllers, holding its @c "kp", @c "ki" and @c "kd".
+ */
+void send_gains (void)
+{
+    String json;
+    StringPrinter printer (json);
+    printer.print ("{");
+    for (uint8_t index = 0; index < sizeof (gain_controllers)
+                                    / sizeof (gain_controllers[0]); index++)
+    {
+        const PIDGains& gains = gain_controllers[index].surface_loop
+            ? web_gains.surface[gain_controllers[index].axis]
+            : web_gains.attitude[gain_controllers[index].axis];
+        printer.printf ("%s\"%s\":{\"kp\":%g,\"ki\":%g,\"kd\":%g}",
+                        index ? "," : "", gain_controllers[index].name,
+                        gains.Kp, gains.Ki, gains.Kd);
+    }
+    printer.print ("}");
+
+    server.send (200, "application/json", json);
+}
+
+
+/** @brief   Read one gain from the arguments of a request.
+ *  @param   arg_name The name of the argument, such as @c "kp"
+ *  @param   value Set to the gain if the argument is given and not empty
+ *  @returns @c false if the argument was given but isn't a finite number
+ */
+bool get_gain_arg (const char* arg_name, float& value)
+{
+    String text = server.arg (arg_name);
+    if (text.length () == 0)
+    {
+        return true;
+    }
+
+    char* p_end;
+    float number = strtof (text.c_str (), &p_end);
+    if (*p_end != '\0' || !isfinite (number))
+    {
+        return false;
+    }
+    value = number;
+    return true;
+}
+
+
+/** @brief   Responds to a request for the gains of every controller.
+ */
+void handle_Gains (void)
+{
+    send_gains ();
+}
+
+
+/** @brief   Sets the gains of one controller while the control loops run.
+ *  @details The request's @c controller argument names the controller, such
+ *           as @c yaw2rudder, and its @c kp, @c ki and @c kd arguments give
+ *           new gains; any which are missing or empty are left as they were.
+ *           The whole set of gains is put into @c controller_gains, and each
+ *           control loop loads it at the start of its next iteration. The
+ *           gains aren't saved in flash until @c /gains/save is requested.
+ *           The reply is the new gains as JSON, or an error if the request
+ *           was bad.
+ */
+void handle_SetGains (void)
+{
+    String name = server.arg ("controller");
+    for (uint8_t index = 0; index < sizeof (gain_controllers)
+                                    / sizeof (gain_controllers[0]); index++)
+    {
+        if (name == gain_controllers[index].name)
+        {
+            PIDGains gains = gain_controllers[index].surface_loop
+                ? web_gains.surface[gain_controllers[index].axis]
+                : web_gains.attitude[gain_controllers[index].axis];
+            if (!get_gain_arg ("kp", gains.Kp) || !get_gain_arg ("ki", gains.Ki)
+                || !get_gain_arg ("kd", gains.Kd))
+            {
+                server.send (400, "text/plain", "Gains must be numbers");
+                return;
+            }
+
+            if (gain_controllers[index].surface_loop)
+            {
+                web_gains.surface[gain_controllers[index].axis] = gains;
+            }
+            else
+            {
+                web_gains.attitude[gain_controllers[index].axis] = gains;
+            }
+            controller_gains.put (web_gains);
+
+            Serial << "Gains of " << name << ": " << gains.Kp << ", "
+                   << gains.Ki << ", " << gains.Kd << endl;
+            send_gains ();
+            return;
+        }
+    }
+    server.send (400, "text/plain", "Unknown controller");
+}
+
+
+/** @brief   Puts the default gains back into every controller.
+ *  @details The saved gains are left alone until @c /gains/save is requested.
+ */
+void handle_ResetGains (void)
+{
+    web_gains = DEFAULT_GAINS;
+    controller_gains.put (web_gains);
+
+    Serial << "Gains reset to defaults" << endl;
+    send_gains ();
+}
+
+
+/** @brief   Saves the gains of every controller in flash.
+ *  @details Writing flash stalls both cores, so the request is refused with
+ *           error 409 unless the controller is disabled. The reply is the
+ *           saved gains as JSON.
+ */
+void handle_SaveGains (void)
+{
+    if (tc_state.get () != STATE_DISABLED)
+    {
+        server.send (409, "text/plain", "Deactivate flight control first");
+        return;
+    }
+    if (!save_gains (web_gains))
+    {
+        server.send (500, "text/plain", "Gains could not be saved");
+        return;
+    }
+
+    Serial << "Gains saved" << endl;
+    send_gains ();
+}
+
+
+/** @brief   Sends the gain schedules of the attitude controllers as JSON.
+ *  @details The JSON object has one member for each attitude controller,
+ *           holding its schedule's @c "input", @c "height" or @c "pitch", and
+ *           its @c "points", each of which is an array of the input and the
+ *           factors for Kp, Ki and Kd.
+ */
+void send_schedules (void)
+{
+    String json;
+    StringPrinter printer (json);
+    printer.print ("{");
+    for (uint8_t index = 0; index < sizeof (gain_controllers)
+                                    / sizeof (gain_controllers[0]); index++)
+    {
+        if (gain_controllers[index].surface_loop)
+        {
+            continue;
+        }
+        const GainSchedule& schedule
+            = web_schedules.attitude[gain_controllers[index].axis];
+        printer.printf ("%s\"%s\":{\"input\":\"%s\",\"points\":[",
+                        index ? "," : "", gain_controllers[index].name,
+                        schedule.input == SCHEDULE_BY_PITCH ? "pitch" : "height");
+        for (uint8_t point = 0; point < schedule.points; point++)
+        {
+            const GainBreakpoint& breakpoint = schedule.table[point];
+            printer.printf ("%s[%g,%g,%g,%g]", point ? "," : "",
+                            breakpoint.input, breakpoint.scale.Kp,
+                            breakpoint.scale.Ki, breakpoint.scale.Kd);
+        }
+        printer.print ("]}");
+    }
+    printer.print ("}");
+
+    server.send (200, "application/json", json);
+}
+
+
+/** @brief   Responds to a request for the gain schedules.
+ */
+void handle_Schedule (void)
+{
+    send_schedules ();
+}
+
+
+/** @brief   Replaces the gain schedule of one attitude controller.
+ *  @details The request's @c controller argument names the controller,
+ *           @c yaw2rudder or @c pitch2elev; @c input is @c height or @c pitch;
+ *           and @c points lists the breakpoints in order of increasing input,
+ *           each as @c input:kp:ki:kd with the factors for the gains,
+ *           separated by commas. For example,
+ *           @c points=0:1.5:1:1,20:1.5:1:1,60:1:1:1 raises Kp by half below a
+ *           height of 20 cm. The attitude loop loads the new schedule at the
+ *           start of its next iteration.
+ */
+void handle_SetSchedule (void)
+{
+    String name = server.arg ("controller");
+    for (uint8_t index = 0; index < sizeof (gain_controllers)
+                                    / sizeof (gain_controllers[0]); index++)
+    {
+        if (gain_controllers[index].surface_loop
+            || name != gain_controllers[index].name)
+        {
+            continue;
+        }
+
+        GainSchedule schedule;
+        String input = server.arg ("input");
+        if (input == "pitch")
+        {
+            schedule.input = SCHEDULE_BY_PITCH;
+        }
+        else if (input == "height" || input.length () == 0)
+        {
+            schedule.input = SCHEDULE_BY_HEIGHT;
+        }
+        else
+        {
+            server.send (400, "text/plain", "Input must be height or pitch");
+            return;
+        }
+
+        // Read breakpoints of the form input:kp:ki:kd, separated by commas
+        String text = server.arg ("points");
+        const char* p_text = text.c_str ();
+        schedule.points = 0;
+        while (*p_text != '\0' && schedule.points < SCHEDULE_POINTS)
+        {
+            GainBreakpoint& point = schedule.table[schedule.points++];
+            char* p_end;
+            float* p_field[] = {&point.input, &point.scale.Kp,
+                                &point.scale.Ki, &point.scale.Kd};
+            for (uint8_t field = 0; field < 4; field++)
+            {
+                *p_field[field] = strtof (p_text, &p_end);
+                if (p_end == p_text || (field < 3 && *p_end != ':'))
+                {
+                    server.send (400, "text/plain", "Badly formed points");
+                    return;
+                }
+                p_text = (field < 3) ? p_end + 1 : p_end;
+            }
+            if (*p_text == ',')
+            {
+                p_text++;
+            }
+            else if (*p_text != '\0')
+            {
+                server.send (400, "text/plain", "Badly formed points");
+                return;
+            }
+        }
+        if (*p_text != '\0' || !schedule_is_valid (schedule))
+        {
+            String message = "Need 1 to ";
+            message += SCHEDULE_POINTS;
+            message += " points in order of increasing input";
+            server.send (400, "text/plain", message);
+            return;
+        }
+
+        web_schedules.attitude[gain_controllers[index].axis] = schedule;
+        gain_schedules.put (web_schedules);
+
+        Serial << "Gain schedule of " << name << " has " << schedule.points
+               << " points" << endl;
+        send_schedules ();
+        return;
+    }
+    server.send (400, "text/plain", "Unknown attitude controller");
+}
+
+
+/** @brief   Puts the default gain schedules back into the attitude loop.
+ */
+void handle_ResetSchedule (void)
+{
+    web_schedules = DEFAULT_SCHEDULES;
+    gain_schedules.put (web_schedules);
+
+    Serial << "Gain schedules reset to defaults" << endl;
+    send_schedules ();
+}
+
+
+/** @brief   Sends the gains of the IMU's attitude filter as JSON.
+ *  @details The JSON object holds the filter's @c "kp" and @c "ki".
+ */
+void send_filter_gains (void)
+{
+    String json;
+    StringPrinter printer (json);
+    printer.printf ("{\"kp\":%g,\"ki\":%g}", web_filter_gains.kp,
+                    web_filter_gains.ki);
+    server.send (200, "application/json", json);
+}
+
+
+/** @brief   Responds to a request for the gains of the attitude filter.
+ */
+void handle_FilterGains (void)
+{
+    send_filter_gains ();
+}
+
+
+/** @brief   Sets the gains of the IMU's attitude filter while it runs.
+ *  @details The request's @c kp and @c ki arguments give new gains; either
+ *           may be left out or empty to keep it as it was. The gains are put
+ *           into @c filter_gains, which the IMU task loads before its next
+ *           reading. Unlike the controller gains they can't be saved in
+ *           flash, so the defaults in @c attitudefilter.h are used after a
+ *           restart. The reply is the new gains as JSON, or an error if the
+ *           request was bad.
+ */
+void handle_SetFilterGains (void)
+{
+    MahonyGains gains = web_filter_gains;
+    if (!get_gain_arg ("kp", gains.kp) || !get_gain_arg ("ki", gains.ki)
+        || gains.kp < 0 || gains.ki < 0)
+    {
+        server.send (400, "text/plain", "Gains must be numbers, 0 or more");
+        return;
+    }
+    web_filter_gains = gains;
+    filter_gains.put (web_filter_gains);
+
+    Serial << "Filter gains: " << gains.kp << ", " << gains.ki << endl;
+    send_filter_gains ();
+}
+
+
+/** @brief   Uses and saves the surface gains found by an autotune, if any.
+ *  @details The gains of each surface which was tuned successfully are put
+ *           into the gain set and sent to the control loops, and the whole
+ *           set is saved in flash. A result is only taken once the controller
+ *           has gone back to being disabled, as writing flash stalls both
+ *           cores. If no surface was tuned, nothing is changed or saved.
+ *  @param   updates_seen The number of autotune results already used, which
+ *           is updated
+ */
+void check_autotune (uint32_t& updates_seen)
+{
+    TuneResult result;
+    if (tc_state.get () != STATE_DISABLED
+        || !autotune_result.get_if_updated (result, updates_seen))
+    {
+        return;
+    }
+
+    bool any_tuned = false;
+    for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
+    {
+        if (result.status[axis] == TUNE_DONE)
+        {
+            web_gains.surface[axis] = result.gains[axis];
+            any_tuned = true;
+        }
+    }
+    if (!any_tuned)
+    {
+        Serial << "Autotune failed; gains not changed" << endl;
+        return;
+    }
+    controller_gains.put (web_gains);
+    if (save_gains (web_gains))
+    {
+        Serial << "Autotuned gains saved" << endl;
+    }
+    else
+    {
+        Serial << "Autotuned gains in use but could not be saved" << endl;
+    }
+}
+
+
 /** @brief   Task which sets up and runs a web server.
  *  @details After setup, function @c handleClient() must be run periodically
  *           to check for page requests from web clients. One could run this
  *           task as the lowest priority task with a short or no delay, as there
  *           generally isn't much rush in replying to web queries.
- *  @param   p_params Pointer to unused parameters
+ *  @param   p_params A pointer to this task's @c PeriodicTask object, passed
+ *           by the object's @c start() method
  */
 void task_webserver (void* p_params)
 {
+    PeriodicTask* p_task = (PeriodicTask*)p_params;
+
     // The server has been created statically when the program was started and
     // is accessed as a global object because not only this function but also
     // the page handling functions referenced below need access to the server
@@ -271,8 +831,29 @@ void task_webserver (void* p_params)
     server.on ("/activate", handle_Activate);
     server.on ("/deactivate", handle_Deactivate);
     server.on ("/calibrate", handle_Calibrate);
+    server.on ("/autotune", handle_Autotune);
+    server.on ("/shares", handle_Shares);
+    server.on ("/stats", handle_Stats);
+    server.on ("/transitions", handle_Transitions);
+    server.on ("/gains", handle_Gains);
+    server.on ("/gains/set", handle_SetGains);
+    server.on ("/gains/reset", handle_ResetGains);
+    server.on ("/gains/save", handle_SaveGains);
+    server.on ("/filter", handle_FilterGains);
+    server.on ("/filter/set", handle_SetFilterGains);
+    server.on ("/schedule", handle_Schedule);
+    server.on ("/schedule/set", handle_SetSchedule);
+    server.on ("/schedule/reset", handle_ResetSchedule);
     server.onNotFound (handle_NotFound);
 
+    // Use the gains saved in flash by an earlier autotune or web page
+    if (load_saved_gains (web_gains))
+    {
+        controller_gains.put (web_gains);
+        Serial.println ("Using saved gains");
+    }
+    uint32_t autotunes_seen = autotune_result.count ();
+
     // Get the web server running
     server.begin ();
     Serial.println ("HTTP server started");
@@ -281,6 +862,7 @@ void task_webserver (void* p_params)
     {
         // The web server must be periodically run to watch for page requests
         server.handleClient ();
-        vTaskDelay (500);
+        check_autotune (autotunes_seen);
+        p_task->wait_for_next_period ();
     }
 }
\ No newline at end of file
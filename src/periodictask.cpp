@@ -0,0 +1,178 @@
+/** @file    periodictask.cpp
+ *  @brief   Source code for a class which runs an RTOS task at a fixed period
+ *           and keeps track of how well it keeps to its schedule.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Added @c wait_for_notification() for timer-driven tasks
+ */
+
+#include "periodictask.h"
+
+
+/** @brief   Set up the period and clear the timing statistics.
+ *  @param   a_period The time between runs of the task in RTOS ticks
+ */
+void PeriodicTask::setup_timing (TickType_t a_period)
+{
+    period = (a_period > 0) ? a_period : 1;
+    period_us = period * portTICK_PERIOD_MS * 1000UL;
+    last_wake = 0;
+    schedule_start = 0;
+    releases = 0;
+    release_time = 0;
+    timing = false;
+    restarted = true;
+
+    overruns = 0;
+    max_jitter_us = 0;
+}
+
+
+/** @brief   Record the time taken by the pass which has just finished.
+ *  @details Nothing is recorded for the task's setup code, which runs before
+ *           the first call to one of the waiting methods.
+ *  @param   check_deadline If @c true, a pass taking longer than one period
+ *           is counted as an overrun
+ */
+void PeriodicTask::end_pass (bool check_deadline)
+{
+    if (!timing)
+    {
+        return;
+    }
+
+    uint32_t exec_us = profiler.end ();
+    if (check_deadline && exec_us > period_us)
+    {
+        overruns++;
+    }
+}
+
+
+/** @brief   Sleep until the next release time, then begin timing the next pass.
+ *  @details Release times are whole periods apart, no matter how long each
+ *           pass takes. If the next release time has already gone by, the
+ *           pass is counted as an overrun and the schedule starts again one
+ *           period from now. The time at which the task actually wakes is
+ *           compared with the time at which it should have, and the largest
+ *           difference is kept as the release jitter.
+ */
+void PeriodicTask::wait_for_next_period (void)
+{
+    end_pass (false);
+
+    TickType_t now = xTaskGetTickCount ();
+    if (!timing || (TickType_t)(now - last_wake) >= period)
+    {
+        if (timing)
+        {
+            overruns++;
+        }
+        last_wake = now;
+        restarted = true;
+    }
+
+    vTaskDelayUntil (&last_wake, period);
+    begin_pass ();
+
+    // Release times are measured from the first release after the schedule
+    // (re)started, which lies on a tick boundary
+    if (restarted)
+    {
+        schedule_start = release_time;
+        releases = 0;
+        restarted = false;
+    }
+    else
+    {
+        releases++;
+        int64_t late = release_time
+                       - (schedule_start + (int64_t)releases * period_us);
+        if (late > (int64_t)max_jitter_us)
+        {
+            max_jitter_us = (uint32_t)late;
+        }
+    }
+}
+
+
+/** @brief   Sleep until an interrupt wakes the task, then begin timing the
+ *           next pass.
+ *  @details The interrupt, usually that of a hardware timer which fires once
+ *           per period, wakes the task with @c vTaskNotifyGiveFromISR(). Each
+ *           notification which arrived while the task was still busy with
+ *           the previous pass counts as an overrun. Release jitter is
+ *           measured from one wakeup to the next, as the timer sets the
+ *           schedule. If no notification comes within two periods the wait
+ *           times out, so a stopped timer can't hang the task.
+ *  @returns @c true if the task was woken by a notification, @c false if the
+ *           wait timed out
+ */
+bool PeriodicTask::wait_for_notification (void)
+{
+    end_pass (false);
+    bool was_timing = timing;
+    int64_t previous_release = release_time;
+
+    uint32_t count = ulTaskNotifyTake (pdTRUE, 2 * period);
+    begin_pass ();
+
+    if (count > 1)
+    {
+        overruns += count - 1;
+    }
+    if (count > 0 && was_timing)
+    {
+        int64_t late = release_time - previous_release - period_us;
+        if (late > (int64_t)max_jitter_us)
+        {
+            max_jitter_us = (uint32_t)late;
+        }
+    }
+    return count > 0;
+}
+
+
+/** @brief   Print the period and timing statistics in the list of tasks.
+ *  @details The columns are the period in ticks, the number of passes timed,
+ *           the percentage of the time spent running, the shortest, average,
+ *           99th percentile and longest pass and the largest release jitter in
+ *           microseconds, and the number of overruns.
+ *  @param   printer Reference to a serial device on which to print
+ */
+void PeriodicTask::print_timing (Print& printer)
+{
+    printer.printf ("%8lu%10lu%7.1f%9lu%9lu%9lu%9lu%9lu%9lu",
+                    (unsigned long)period,
+                    (unsigned long)profiler.get_count (),
+                    profiler.get_load (),
+                    (unsigned long)profiler.get_min_us (),
+                    (unsigned long)profiler.get_average_us (),
+                    (unsigned long)profiler.get_percentile_us (99),
+                    (unsigned long)profiler.get_max_us (),
+                    (unsigned long)max_jitter_us, (unsigned long)overruns);
+}
+
+
+/** @brief   Print the period and timing statistics as fields of a JSON object.
+ *  @details Each field is preceded by a comma, as the fields printed by
+ *           @c StaticTask::print_json() come first. Times are in
+ *           microseconds except the period, which is in ticks.
+ *  @param   printer Reference to a serial device on which to print
+ */
+void PeriodicTask::print_timing_json (Print& printer)
+{
+    printer.printf (",\"period\":%lu,\"runs\":%lu,\"load\":%.2f",
+                    (unsigned long)period,
+                    (unsigned long)profiler.get_count (),
+                    profiler.get_load ());
+    printer.printf (",\"min_us\":%lu,\"avg_us\":%lu,\"p99_us\":%lu"
+                    ",\"max_us\":%lu",
+                    (unsigned long)profiler.get_min_us (),
+                    (unsigned long)profiler.get_average_us (),
+                    (unsigned long)profiler.get_percentile_us (99),
+                    (unsigned long)profiler.get_max_us ());
+    printer.printf (",\"jitter_us\":%lu,\"overruns\":%lu",
+                    (unsigned long)max_jitter_us, (unsigned long)overruns);
+}
@@ -0,0 +1,173 @@
+/** @file    periodictask.h
+ *  @brief   Headers for a class which runs an RTOS task at a fixed period and
+ *           keeps track of how well it keeps to its schedule.
+ *  @details A task which ends each pass through its loop with
+ *           @c vTaskDelay(period) runs every period plus however long the
+ *           loop took, and that time changes with Serial output and WiFi
+ *           load. A @c PeriodicTask instead wakes at fixed times with
+ *           @c vTaskDelayUntil(). It measures how long each pass takes with
+ *           a @c LoopProfiler, and how late the task is woken and how often
+ *           it misses its deadline with @c esp_timer_get_time().
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Passes timed in CPU cycles by a @c LoopProfiler
+ *  @date   2026-Oct-16 Added @c wait_for_notification() for timer-driven tasks
+ */
+
+// This define prevents this .h file from being included more than once
+#ifndef _PERIODICTASK_H_
+#define _PERIODICTASK_H_
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "statictask.h"
+#include "profiler.h"
+
+
+/** @brief   Class for a statically allocated RTOS task which runs at a fixed
+ *           period.
+ *  @details The task function is given a pointer to its @c PeriodicTask as
+ *           its parameter. It does its setup, then loops, calling
+ *           @c wait_for_next_period() at the end of each pass. A task which
+ *           runs when new data arrives in a share rather than at fixed times
+ *           calls @c wait_for_update() instead; the period is then the longest
+ *           time it will sleep without new data. A task which is woken by
+ *           an interrupt, such as that of a hardware timer firing faster than
+ *           the RTOS tick, calls @c wait_for_notification().
+ *
+ *           If a pass runs past the next release time, that release is counted
+ *           as an overrun and the schedule restarts from the current time,
+ *           rather than running several passes back to back to catch up.
+ *
+ *           @section usage_periodictask Usage
+ *           @code{.cpp}
+ *           void task_antlers (void* p_params)
+ *           {
+ *               PeriodicTask* p_task = (PeriodicTask*)p_params;
+ *               ...
+ *               while (true)
+ *               {
+ *                   measure_antlers ();
+ *                   p_task->wait_for_next_period ();
+ *               }
+ *           }
+ *
+ *           StackType_t antler_stack[2048];
+ *
+ *           /// Antler task, priority 5, runs every 20 ms
+ *           PeriodicTask antler_task ("Antlers", task_antlers, antler_stack,
+ *                                     5, 20);
+ *           ...
+ *           antler_task.start ();         // In setup()
+ *           @endcode
+ */
+class PeriodicTask : public StaticTask
+{
+protected:
+    TickType_t period;                  ///< Time between releases in ticks
+    uint32_t period_us;                 ///< Time between releases (us)
+    TickType_t last_wake;               ///< Tick count at the latest release
+    int64_t schedule_start;             ///< Time of the first timed release
+    uint32_t releases;                  ///< Timed releases since that one
+    int64_t release_time;               ///< Time the current pass began (us)
+    bool timing;                        ///< Whether a pass is being timed
+    bool restarted;                     ///< Whether the schedule is restarting
+
+    LoopProfiler profiler;              ///< Times each pass through the loop
+    uint32_t overruns;                  ///< Passes which missed a deadline
+    uint32_t max_jitter_us;             ///< Latest any timed release woke (us)
+
+    // Set up the timing variables for a new task
+    void setup_timing (TickType_t a_period);
+
+    // Record the time taken by the pass which has just finished
+    void end_pass (bool check_deadline);
+
+    /// Note the time at which a pass begins; the first one starts the profile
+    void begin_pass (void)
+    {
+        if (!timing)
+        {
+            profiler.reset ();
+        }
+        release_time = esp_timer_get_time ();
+        profiler.begin ();
+        timing = true;
+    }
+
+    // Print the period and timing statistics within a list of tasks
+    virtual void print_timing (Print& printer);
+
+    // Print the period and timing statistics as JSON fields
+    virtual void print_timing_json (Print& printer);
+
+public:
+    /** @brief   Construct a periodic task which will run with the given stack.
+     *  @param   p_name The name of the task, shown in task lists
+     *  @param   p_function The function which runs the task
+     *  @param   stack An array, usually a global variable, used as the stack
+     *  @param   a_priority The RTOS priority of the task
+     *  @param   a_period The time between runs of the task in RTOS ticks,
+     *           which are milliseconds on the ESP32
+     *  @param   a_core The CPU core on which the task is to run (default:
+     *           @c tskNO_AFFINITY, either core)
+     */
+    template <size_t size>
+    PeriodicTask (const char* p_name, TaskFunction_t p_function,
+                  StackType_t (&stack)[size], UBaseType_t a_priority,
+                  TickType_t a_period, BaseType_t a_core = tskNO_AFFINITY)
+        : StaticTask (p_name, p_function, stack, a_priority, a_core)
+    {
+        setup_timing (a_period);
+    }
+
+    /** @brief   Create the RTOS task and start it running.
+     *  @details The task function is given a pointer to this object as its
+     *           parameter so that it can call @c wait_for_next_period().
+     *  @returns @c true if the task is running, @c false if it couldn't be made
+     */
+    bool start (void)
+    {
+        return StaticTask::start (this);
+    }
+
+    // Sleep until the next release time, then begin timing the next pass
+    void wait_for_next_period (void);
+
+    /** @brief   Sleep until a share has new data or one period has passed.
+     *  @details This is for tasks which run when another task produces data,
+     *           such as the motor tasks. The time spent running each pass is
+     *           recorded; a pass which takes longer than the period counts as
+     *           an overrun. Release jitter isn't measured, as the release
+     *           times are set by the other task.
+     *  @param   share A share with a @c wait_for_update() method
+     *  @returns @c true if the share has new data, @c false if the wait timed
+     *           out
+     */
+    template <class ShareType>
+    bool wait_for_update (ShareType& share)
+    {
+        end_pass (true);
+        bool updated = share.wait_for_update (period);
+        begin_pass ();
+        return updated;
+    }
+
+    // Sleep until an interrupt, such as a hardware timer's, wakes the task
+    bool wait_for_notification (void);
+
+    /// Return the time between releases in RTOS ticks
+    TickType_t get_period (void) { return period; }
+
+    /// Return the profiler which times the passes through the task's loop
+    LoopProfiler& get_profiler (void) { return profiler; }
+
+    /// Return the number of passes which overran their deadlines
+    uint32_t get_overruns (void) { return overruns; }
+
+    /// Return the latest that the task has woken after a release time (us)
+    uint32_t get_max_jitter_us (void) { return max_jitter_us; }
+};
+
+#endif // _PERIODICTASK_H_
@@ -0,0 +1,312 @@
+/** @file    pidbank.h
+ *  @brief   A set of PID controllers which are all updated in one pass.
+ *  @details A @c PIDBank keeps the gains, integrals and filter states of all
+ *           its axes in separate arrays rather than in one object per axis,
+ *           so one loop with no calls runs every axis. The compiler can
+ *           unroll or vectorize that loop. Each axis's output is clamped to
+ *           its own limits inside the loop, so the code which uses the bank
+ *           doesn't have to saturate each output itself.
+ *
+ *           The bank may be given the time of each update, in which case the
+ *           integral and derivative terms use the measured time since the
+ *           previous update rather than the nominal interval; jitter from
+ *           Serial prints or WiFi then doesn't distort them. The derivative
+ *           acts on the measurement, not the error, so a step in the desired
+ *           value doesn't kick the output, and it can be smoothed by a
+ *           first-order low-pass filter. The integral stops growing while the
+ *           output is held at a limit by an error which would push it further
+ *           (conditional integration), so it doesn't wind up.
+ *
+ *           The terms may be @c float or a fixed-point type from
+ *           @c fixedpoint.h. Times are in milliseconds, as in
+ *           @c PIDController.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Measured time steps, filtered derivative on
+ *                      measurement and anti-windup
+ *  @date   2026-Oct-16 Derivative filter gains found outside the axis loop
+ *  @date   2026-Oct-16 Filter gains kept for the nominal interval and only
+ *                      found again when a step is well off it
+ */
+
+#ifndef _PIDBANK_H_
+#define _PIDBANK_H_
+
+#include <Arduino.h>
+#include "fixedpoint.h"
+
+
+/** @brief   Class for a bank of @c N PID controllers run together.
+ *  @details Axes are numbered from 0; an enumeration of axis names makes the
+ *           code which uses a bank easier to read. Adding an axis means
+ *           making the bank larger and setting that axis's gains and limits.
+ *
+ *           @section usage_bank Usage
+ *           @code{.cpp}
+ *           PIDBank<2> bank (50);                  // Two axes, every 50 ms
+ *           bank.set_gains (0, 1, 0.01, 5);        // Kp, Ki, Kd for axis 0
+ *           bank.set_limits (0, -50, 50);
+ *           bank.set_filter (0, 20);               // Smooth D over 20 ms
+ *           ...
+ *           float measured[2], desired[2], output[2];
+ *           bank.update (measured, desired, output, micros ());
+ *           @endcode
+ *  @tparam  N The number of axes
+ *  @tparam  T The number type, @c float or a @c Fixed type
+ */
+template <uint8_t N, class T = float>
+class PIDBank
+{
+protected:
+    T Kp[N];                    ///< Proportional gains
+    T Ki[N];                    ///< Integral gains (per ms)
+    T Kd[N];                    ///< Derivative gains (ms)
+    float filter_ms[N];         ///< Derivative filter time constants (ms)
+    T out_min[N];               ///< Lowest output of each axis
+    T out_max[N];               ///< Highest output of each axis
+
+    T alpha[N];                 ///< Filter gains for the nominal interval
+
+    T integral[N];              ///< Integrals of error, times integral gains
+    T rate[N];                  ///< Filtered rates of change of measurements
+    T meas_prev[N];             ///< Measurements at the previous update
+
+    float nominal_dt;           ///< Interval at which the bank runs (ms)
+    uint32_t last_us;           ///< Time of the previous update (us)
+    bool started;               ///< Whether updated since the last reset
+
+public:
+    // Create a bank with zero gains and no output limits
+    PIDBank (float a_dt);
+
+    // Set the gains of one axis
+    void set_gains (uint8_t axis, float a_Kp, float a_Ki, float a_Kd);
+
+    // Set the lowest and highest outputs of one axis
+    void set_limits (uint8_t axis, float a_min, float a_max);
+
+    // Set the time constant of one axis's derivative filter
+    void set_filter (uint8_t axis, float a_filter_ms);
+
+    // Clear the integrals and derivative filters of all axes
+    void reset (void);
+
+    // Run every axis's controller once, a given time after the last run
+    void update_dt (const T* p_measured, const T* p_desired, T* p_output,
+                    float dt);
+
+    // Run every axis's controller once, at a given time
+    void update (const T* p_measured, const T* p_desired, T* p_output,
+                 uint32_t time_us);
+
+    /// Run every axis's controller once, assuming the nominal interval
+    void update (const T* p_measured, const T* p_desired, T* p_output)
+    {
+        update_dt (p_measured, p_desired, p_output, nominal_dt);
+    }
+
+    /// Return the number of axes in the bank
+    uint8_t size (void) const { return N; }
+};
+
+
+/** @brief   Create a bank of controllers with zero gains and no limits.
+ *  @details The limits are initially the largest and smallest values of
+ *           @c T which can be made from a @c float, and the derivatives are
+ *           not filtered.
+ *  @param   a_dt The interval at which the bank is meant to be updated (ms)
+ */
+template <uint8_t N, class T>
+PIDBank<N, T>::PIDBank (float a_dt)
+{
+    nominal_dt = a_dt;
+    for (uint8_t axis = 0; axis < N; axis++)
+    {
+        set_gains (axis, 0, 0, 0);
+        set_limits (axis, -1.0e9f, 1.0e9f);
+        set_filter (axis, 0);
+    }
+    reset ();
+}
+
+
+/** @brief   Set the gains of one axis.
+ *  @details The integral is kept already multiplied by the integral gain, so
+ *           changing the gains doesn't make the output jump.
+ *  @param   axis The number of the axis, from 0 to @c N - 1
+ *  @param   a_Kp Proportional gain
+ *  @param   a_Ki Integral gain (per ms)
+ *  @param   a_Kd Derivative gain (ms)
+ */
+template <uint8_t N, class T>
+void PIDBank<N, T>::set_gains (uint8_t axis, float a_Kp, float a_Ki,
+                               float a_Kd)
+{
+    if (axis < N)
+    {
+        Kp[axis] = T (a_Kp);
+        Ki[axis] = T (a_Ki);
+        Kd[axis] = T (a_Kd);
+    }
+}
+
+
+/** @brief   Set the lowest and highest outputs of one axis.
+ *  @param   axis The number of the axis, from 0 to @c N - 1
+ *  @param   a_min The lowest output
+ *  @param   a_max The highest output
+ */
+template <uint8_t N, class T>
+void PIDBank<N, T>::set_limits (uint8_t axis, float a_min, float a_max)
+{
+    if (axis < N)
+    {
+        out_min[axis] = T (a_min);
+        out_max[axis] = T (a_max);
+    }
+}
+
+
+/** @brief   Set the time constant of one axis's derivative filter.
+ *  @details A longer time constant smooths out more noise but delays the
+ *           derivative term more. A time constant of zero turns the filter
+ *           off. The filter's gain for the nominal interval is found here, so
+ *           that updates at about that interval needn't divide to find it.
+ *  @param   axis The number of the axis, from 0 to @c N - 1
+ *  @param   a_filter_ms The filter's time constant (ms)
+ */
+template <uint8_t N, class T>
+void PIDBank<N, T>::set_filter (uint8_t axis, float a_filter_ms)
+{
+    if (axis < N)
+    {
+        filter_ms[axis] = (a_filter_ms > 0) ? a_filter_ms : 0;
+        alpha[axis] = T (nominal_dt / (filter_ms[axis] + nominal_dt));
+    }
+}
+
+
+/** @brief   Clear the integrals and derivative filters of all axes.
+ *  @details The next update is then taken to be a nominal interval after the
+ *           last, and its measurements have no rate of change. This should be
+ *           done when the outputs haven't been used for a while, such as when
+ *           a controller is turned back on.
+ */
+template <uint8_t N, class T>
+void PIDBank<N, T>::reset (void)
+{
+    for (uint8_t axis = 0; axis < N; axis++)
+    {
+        integral[axis] = 0;
+        rate[axis] = 0;
+        meas_prev[axis] = 0;
+    }
+    last_us = 0;
+    started = false;
+}
+
+
+/** @brief   Run every axis's controller once, a given time after the last run.
+ *  @details The reciprocal of the time step is found once for all the axes,
+ *           so the loop over the axes has no divisions or conversions from
+ *           @c float. The derivative filters use the gains found for the
+ *           nominal interval unless the step is more than an eighth of that
+ *           interval away from it; the measured step of a task almost never
+ *           equals the nominal one exactly, but a small difference changes
+ *           the filter's time constant only as much as it changes the step.
+ *           The integral is only updated if that wouldn't push an output
+ *           further past its limit.
+ *  @param   p_measured Array of @c N measured values
+ *  @param   p_desired Array of @c N desired values
+ *  @param   p_output Array into which the @c N clamped outputs are written
+ *  @param   dt The time since the previous update (ms)
+ */
+template <uint8_t N, class T>
+void PIDBank<N, T>::update_dt (const T* p_measured, const T* p_desired,
+                               T* p_output, float dt)
+{
+    if (!started)
+    {
+        for (uint8_t axis = 0; axis < N; axis++)
+        {
+            meas_prev[axis] = p_measured[axis];
+        }
+        started = true;
+    }
+
+    T step = T (dt);
+    T inverse_step = T (1.0f / dt);
+
+    // Filter gains for a step far from the nominal one, such as after a pause
+    const T* p_alpha = alpha;
+    T step_alpha[N];
+    float jitter = dt - nominal_dt;
+    if (jitter > nominal_dt * 0.125f || jitter < nominal_dt * -0.125f)
+    {
+        for (uint8_t axis = 0; axis < N; axis++)
+        {
+            step_alpha[axis] = T (dt / (filter_ms[axis] + dt));
+        }
+        p_alpha = step_alpha;
+    }
+
+    for (uint8_t axis = 0; axis < N; axis++)
+    {
+        T err = p_desired[axis] - p_measured[axis];
+
+        // Derivative of the measurement through a first-order low-pass filter
+        T raw_rate = (p_measured[axis] - meas_prev[axis]) * inverse_step;
+        rate[axis] += p_alpha[axis] * (raw_rate - rate[axis]);
+        meas_prev[axis] = p_measured[axis];
+
+        // Integrate unless the output is at a limit and the error would push
+        // it further past
+        T p_and_d = Kp[axis] * err - Kd[axis] * rate[axis];
+        T new_integral = integral[axis] + Ki[axis] * err * step;
+        T output = p_and_d + new_integral;
+        bool winding_up = (output > out_max[axis] && err > T (0))
+                          || (output < out_min[axis] && err < T (0));
+        integral[axis] = winding_up ? integral[axis] : new_integral;
+        output = p_and_d + integral[axis];
+
+        output = (output > out_max[axis]) ? out_max[axis] : output;
+        p_output[axis] = (output < out_min[axis]) ? out_min[axis] : output;
+    }
+}
+
+
+/** @brief   Run every axis's controller once, at a given time.
+ *  @details The time step is the time since the previous update. The first
+ *           update after a reset uses the nominal interval, and a step longer
+ *           than four nominal intervals is cut to that, so a pause in the
+ *           updates doesn't make the integral jump.
+ *  @param   p_measured Array of @c N measured values
+ *  @param   p_desired Array of @c N desired values
+ *  @param   p_output Array into which the @c N clamped outputs are written
+ *  @param   time_us The time at which the measurements were made, such as
+ *           from @c micros() (us)
+ */
+template <uint8_t N, class T>
+void PIDBank<N, T>::update (const T* p_measured, const T* p_desired,
+                            T* p_output, uint32_t time_us)
+{
+    float dt = nominal_dt;
+    if (started)
+    {
+        dt = (time_us - last_us) * 0.001f;
+        if (dt <= 0)
+        {
+            dt = nominal_dt;
+        }
+        else if (dt > 4 * nominal_dt)
+        {
+            dt = 4 * nominal_dt;
+        }
+    }
+    last_us = time_us;
+
+    update_dt (p_measured, p_desired, p_output, dt);
+}
+
+#endif // _PIDBANK_H_
@@ -0,0 +1,248 @@
+/** @file    profiler.cpp
+ *  @brief   Source code for classes which measure how long things take: a
+ *           histogram of times, and a profiler which times each pass through
+ *           a task's loop.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Split the histogram into @c TimeHistogram so that it
+ *                      can record latencies; named histograms are listed
+ */
+
+#include "profiler.h"
+
+
+// Set pointer to most recently created named histogram to initially be NULL
+TimeHistogram* TimeHistogram::p_newest = NULL;
+
+
+/** @brief   Create an empty histogram.
+ *  @param   p_name A name for the histogram. If it is given, the histogram is
+ *           shown by @c print_all_histograms() (default: @c NULL)
+ */
+TimeHistogram::TimeHistogram (const char* p_name)
+{
+    name = p_name;
+    p_next = NULL;
+    if (name != NULL)
+    {
+        p_next = p_newest;
+        p_newest = this;
+    }
+    reset ();
+}
+
+
+/** @brief   Clear all the statistics.
+ */
+void TimeHistogram::reset (void)
+{
+    count = 0;
+    min_us = 0xFFFFFFFF;
+    max_us = 0;
+    total_us = 0;
+    memset (bins, 0, sizeof (bins));
+}
+
+
+/** @brief   Find the histogram bin for a time in microseconds.
+ *  @details Times from 0 to 3 us each have their own bin. Above that, each
+ *           doubling of the time is split into four bins, using the two bits
+ *           which follow the most significant one.
+ *  @param   time_us The time to be put in the histogram
+ *  @returns The index of the bin
+ */
+uint8_t TimeHistogram::bin_for (uint32_t time_us)
+{
+    if (time_us < 4)
+    {
+        return time_us;
+    }
+    uint8_t msb = 31 - __builtin_clz (time_us);
+    uint32_t bin = 4 * msb - 4 + ((time_us >> (msb - 2)) & 3);
+    return (bin < PROFILE_BINS) ? bin : PROFILE_BINS - 1;
+}
+
+
+/** @brief   Find the longest time in microseconds which goes in a bin.
+ *  @param   bin The index of the bin
+ *  @returns The longest time which @c bin_for() puts in that bin
+ */
+uint32_t TimeHistogram::bin_top (uint8_t bin)
+{
+    if (bin < 4)
+    {
+        return bin;
+    }
+    uint8_t shift = (bin >> 2) - 1;
+    return ((4UL + (bin & 3)) << shift) + (1UL << shift) - 1;
+}
+
+
+/** @brief   Record one time.
+ *  @param   time_us The time in microseconds
+ */
+void TimeHistogram::record (uint32_t time_us)
+{
+    count++;
+    total_us += time_us;
+    if (time_us < min_us)
+    {
+        min_us = time_us;
+    }
+    if (time_us > max_us)
+    {
+        max_us = time_us;
+    }
+    bins[bin_for (time_us)]++;
+}
+
+
+/** @brief   Return the time within which a given percentage of times fell.
+ *  @details The answer is the top of the histogram bin in which the
+ *           percentile falls, but no longer than the longest time.
+ *  @param   percent The percentage of times, for example 99
+ *  @returns The time in microseconds
+ */
+uint32_t TimeHistogram::get_percentile_us (uint8_t percent)
+{
+    uint32_t wanted = ((uint64_t)count * percent + 99) / 100;
+    uint32_t so_far = 0;
+    uint32_t result = 0;
+
+    for (uint8_t bin = 0; bin < PROFILE_BINS; bin++)
+    {
+        so_far += bins[bin];
+        if (so_far >= wanted)
+        {
+            result = bin_top (bin);
+            break;
+        }
+    }
+    return (result < max_us) ? result : max_us;
+}
+
+
+/** @brief   Print one line of statistics, then ask the next histogram to.
+ *  @param   printer Reference to a serial device on which to print
+ */
+void TimeHistogram::print_in_list (Print& printer)
+{
+    printer.printf ("%-24s%10lu%9lu%9lu%9lu%9lu", name,
+                    (unsigned long)count, (unsigned long)get_min_us (),
+                    (unsigned long)get_average_us (),
+                    (unsigned long)get_percentile_us (99),
+                    (unsigned long)max_us);
+    printer.println ();
+
+    if (p_next != NULL)
+    {
+        p_next->print_in_list (printer);
+    }
+}
+
+
+/** @brief   Print the statistics of every named histogram as a table.
+ *  @param   printer Reference to a serial device on which to print
+ */
+void print_all_histograms (Print& printer)
+{
+    printer.println ("Time                         Count  Min(us)  Avg(us)"
+                     "  P99(us)  Max(us)");
+    printer.println ("----                         -----  -------  -------"
+                     "  -------  -------");
+    if (TimeHistogram::p_newest != NULL)
+    {
+        TimeHistogram::p_newest->print_in_list (printer);
+    }
+}
+
+
+/** @brief   Print the statistics of every named histogram as a JSON array.
+ *  @details Each histogram is an object with its name, count, and minimum,
+ *           average, 99th percentile and maximum times in microseconds.
+ *  @param   printer Reference to a serial device on which to print
+ */
+void print_all_histograms_json (Print& printer)
+{
+    printer.printf ("[");
+    for (TimeHistogram* p_hist = TimeHistogram::p_newest; p_hist != NULL;
+         p_hist = p_hist->p_next)
+    {
+        printer.printf ("{\"name\":\"%s\",\"count\":%lu,\"min_us\":%lu"
+                        ",\"avg_us\":%lu,\"p99_us\":%lu,\"max_us\":%lu}",
+                        p_hist->name, (unsigned long)p_hist->count,
+                        (unsigned long)p_hist->get_min_us (),
+                        (unsigned long)p_hist->get_average_us (),
+                        (unsigned long)p_hist->get_percentile_us (99),
+                        (unsigned long)p_hist->max_us);
+        if (p_hist->p_next != NULL)
+        {
+            printer.printf (",");
+        }
+    }
+    printer.printf ("]");
+}
+
+
+/** @brief   Create a profiler with no passes recorded.
+ */
+LoopProfiler::LoopProfiler (void)
+{
+    start_cycles = 0;
+    start_core = 0;
+    reset ();
+}
+
+
+/** @brief   Clear all the statistics and start measuring the load afresh.
+ */
+void LoopProfiler::reset (void)
+{
+    TimeHistogram::reset ();
+
+    cycles_per_us = ESP.getCpuFreqMHz ();
+    if (cycles_per_us == 0)
+    {
+        cycles_per_us = 240;
+    }
+    reset_time = esp_timer_get_time ();
+}
+
+
+/** @brief   Mark the end of a pass and record how long it took.
+ *  @details A pass which ended on a different core from the one on which it
+ *           began is not recorded, as the two cores' cycle counts differ.
+ *  @returns The duration of the pass in microseconds, or 0 if it couldn't be
+ *           measured
+ */
+uint32_t LoopProfiler::end (void)
+{
+    uint32_t cycles = ESP.getCycleCount () - start_cycles;
+    if (xPortGetCoreID () != start_core)
+    {
+        return 0;
+    }
+
+    uint32_t time_us = cycles / cycles_per_us;
+    record (time_us);
+    return time_us;
+}
+
+
+/** @brief   Return the percentage of the time which the task has spent running.
+ *  @details This is the total time of all passes divided by the time since
+ *           the profiler was reset. A pass lasts from the task's release until
+ *           it waits again, so time during which the task was ready but a
+ *           higher priority task was running is included.
+ *  @returns The load in percent
+ */
+float LoopProfiler::get_load (void)
+{
+    int64_t elapsed_us = esp_timer_get_time () - reset_time;
+    if (elapsed_us <= 0)
+    {
+        return 0.0;
+    }
+    return 100.0 * (float)total_us / (float)elapsed_us;
+}
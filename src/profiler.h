@@ -0,0 +1,148 @@
+/** @file    profiler.h
+ *  @brief   Headers for classes which measure how long things take: a
+ *           histogram of times, and a profiler which times each pass through
+ *           a task's loop.
+ *  @details Passes through a loop are timed with the CPU's cycle counter,
+ *           which at 240 MHz resolves about 4 ns and costs a single
+ *           instruction to read. Times go into a histogram which keeps the
+ *           shortest, average and longest time and from which percentiles
+ *           such as the 99th are found. The same histogram is used on its own
+ *           to record latencies, such as the time from an IMU sample to the
+ *           motor output it causes.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Split the histogram into @c TimeHistogram so that it
+ *                      can record latencies; named histograms are listed
+ */
+
+// This define prevents this .h file from being included more than once
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+
+/// Number of histogram bins; four per octave, covering up to about 2 seconds
+#define PROFILE_BINS 80
+
+
+/** @brief   Class which keeps a histogram of times in microseconds.
+ *  @details Times go into histogram bins whose widths grow with the time,
+ *           four bins per doubling, so percentiles are found to within about
+ *           19% over the whole range from microseconds to seconds, in 320
+ *           bytes.
+ *
+ *           A histogram which is given a name is put into a linked list, as
+ *           shares are, so that @c print_all_histograms() can show it.
+ *
+ *           The statistics are written by one task and may be read by others,
+ *           such as the web server. No lock is used, so a reader may now and
+ *           then see a count from one time and a total from the next, which
+ *           doesn't matter for numbers which are only being looked at.
+ */
+class TimeHistogram
+{
+protected:
+    const char* name;                   ///< Name, or @c NULL if not listed
+    TimeHistogram* p_next;              ///< Next histogram in the list
+
+    /// Pointer to the most recently constructed named histogram
+    static TimeHistogram* p_newest;
+
+    uint32_t count;                     ///< Number of times recorded
+    uint32_t min_us;                    ///< Shortest time
+    uint32_t max_us;                    ///< Longest time
+    uint64_t total_us;                  ///< Total of all times
+    uint32_t bins[PROFILE_BINS];        ///< Number of times in each bin
+
+    // Find the histogram bin for a time in microseconds
+    static uint8_t bin_for (uint32_t time_us);
+
+    // Find the longest time in microseconds which goes in a histogram bin
+    static uint32_t bin_top (uint8_t bin);
+
+public:
+    // Create an empty histogram, listed if it has a name
+    TimeHistogram (const char* p_name = NULL);
+
+    // Clear all the statistics
+    void reset (void);
+
+    // Record one time
+    void record (uint32_t time_us);
+
+    /// Return the number of times recorded
+    uint32_t get_count (void) { return count; }
+
+    /// Return the shortest time recorded in microseconds
+    uint32_t get_min_us (void) { return (count > 0) ? min_us : 0; }
+
+    /// Return the longest time recorded in microseconds
+    uint32_t get_max_us (void) { return max_us; }
+
+    /// Return the average time in microseconds
+    uint32_t get_average_us (void)
+    {
+        return (count > 0) ? (uint32_t)(total_us / count) : 0;
+    }
+
+    // Return the time within which a given percentage of times fell
+    uint32_t get_percentile_us (uint8_t percent);
+
+    // Print this histogram's statistics within a list of histograms
+    void print_in_list (Print& printer);
+
+    friend void print_all_histograms (Print& printer);
+    friend void print_all_histograms_json (Print& printer);
+};
+
+
+/** @brief   Class which times the passes through a task's loop.
+ *  @details The owner calls @c begin() as a pass starts and @c end() as it
+ *           finishes. The time is measured in CPU cycles and recorded in
+ *           microseconds.
+ *
+ *           The cycle counters of the ESP32's two cores are not synchronized,
+ *           so a pass which starts on one core and ends on the other can't be
+ *           timed. Such passes are dropped; tasks which are profiled should be
+ *           pinned to a core.
+ */
+class LoopProfiler : public TimeHistogram
+{
+protected:
+    uint32_t start_cycles;              ///< Cycle count when the pass began
+    BaseType_t start_core;              ///< Core on which the pass began
+    uint32_t cycles_per_us;             ///< CPU clock frequency in MHz
+    int64_t reset_time;                 ///< Time of the last reset (us)
+
+public:
+    // Create a profiler with no passes recorded
+    LoopProfiler (void);
+
+    // Clear all the statistics and start measuring the load afresh
+    void reset (void);
+
+    /// Mark the beginning of a pass
+    void begin (void)
+    {
+        start_core = xPortGetCoreID ();
+        start_cycles = ESP.getCycleCount ();
+    }
+
+    // Mark the end of a pass and record its duration
+    uint32_t end (void);
+
+    // Return the percentage of the time which the task has spent running
+    float get_load (void);
+};
+
+
+// Function that prints the statistics of every named histogram
+void print_all_histograms (Print& printer);
+
+// Function that prints the statistics of every named histogram in JSON
+void print_all_histograms_json (Print& printer);
+
+#endif // _PROFILER_H_
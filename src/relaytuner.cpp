@@ -0,0 +1,156 @@
+/** @file    relaytuner.cpp
+ *  @brief   Source code for a relay-feedback autotuner for a surface position
+ *           loop.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#include "relaytuner.h"
+
+
+/** @brief   Create a tuner with the given relay and safety limits.
+ *  @param   a_relay_duty The duty cycle at which the relay drives the motor;
+ *           larger values give larger swings (%)
+ *  @param   a_hysteresis How far past the center the surface must go before
+ *           the relay switches, which keeps noise from switching it (deg)
+ *  @param   a_max_excursion The experiment fails if the surface moves further
+ *           than this from the center (deg)
+ *  @param   a_timeout_ms The experiment fails if it takes longer than this
+ */
+RelayTuner::RelayTuner (float a_relay_duty, float a_hysteresis,
+                        float a_max_excursion, uint32_t a_timeout_ms)
+{
+    relay_duty = a_relay_duty;
+    hysteresis = a_hysteresis;
+    max_excursion = a_max_excursion;
+    timeout_us = a_timeout_ms * 1000UL;
+    status = TUNE_IDLE;
+    cycles = 0;
+    period_total = 0;
+    amplitude_total = 0;
+}
+
+
+/** @brief   Begin an experiment about a given center angle.
+ *  @param   a_center The angle about which the surface is to swing (deg)
+ *  @param   time_us The present time, such as from @c micros()
+ */
+void RelayTuner::start (float a_center, uint32_t time_us)
+{
+    status = TUNE_RUNNING;
+    center = a_center;
+    drive_up = true;
+    start_us = time_us;
+    last_rise_us = 0;
+    cycles = 0;
+    high_angle = a_center;
+    low_angle = a_center;
+    period_total = 0;
+    amplitude_total = 0;
+}
+
+
+/** @brief   Run the relay once and return the duty cycle for the motor.
+ *  @details Each time the relay switches upward a swing has finished. After
+ *           the first few swings have settled, the period and the amplitude
+ *           of each swing are added up; when enough have been measured the
+ *           experiment is done.
+ *  @param   angle The surface angle now (deg)
+ *  @param   time_us The present time, such as from @c micros()
+ *  @returns The motor duty cycle, or zero if the experiment isn't running
+ */
+int16_t RelayTuner::step (float angle, uint32_t time_us)
+{
+    if (status != TUNE_RUNNING)
+    {
+        return 0;
+    }
+    if (fabs (angle - center) > max_excursion
+        || time_us - start_us > timeout_us)
+    {
+        status = TUNE_FAILED;
+        return 0;
+    }
+
+    high_angle = (angle > high_angle) ? angle : high_angle;
+    low_angle = (angle < low_angle) ? angle : low_angle;
+
+    if (drive_up && angle > center + hysteresis)
+    {
+        drive_up = false;
+    }
+    else if (!drive_up && angle < center - hysteresis)
+    {
+        drive_up = true;
+
+        // A full swing has finished; measure it if the swings have settled
+        if (last_rise_us != 0 && cycles >= TUNE_SETTLE_CYCLES)
+        {
+            period_total += (time_us - last_rise_us) * 0.001f;
+            amplitude_total += (high_angle - low_angle) / 2;
+        }
+        last_rise_us = time_us;
+        cycles++;
+        high_angle = angle;
+        low_angle = angle;
+
+        if (cycles > TUNE_SETTLE_CYCLES + TUNE_MEASURE_CYCLES)
+        {
+            status = (amplitude_total > 0) ? TUNE_DONE : TUNE_FAILED;
+            return 0;
+        }
+    }
+
+    return drive_up ? (int16_t)relay_duty : -(int16_t)relay_duty;
+}
+
+
+/** @brief   Return the ultimate gain found by the experiment.
+ *  @returns The gain at which a proportional controller would make the
+ *           surface oscillate, in duty cycle percent per degree, or 0 if the
+ *           experiment isn't done
+ */
+float RelayTuner::get_ultimate_gain (void) const
+{
+    if (status != TUNE_DONE)
+    {
+        return 0;
+    }
+    float amplitude = amplitude_total / TUNE_MEASURE_CYCLES;
+    return 4 * relay_duty / (PI * amplitude);
+}
+
+
+/** @brief   Return the ultimate period found by the experiment.
+ *  @returns The period of oscillation in milliseconds, or 0 if the
+ *           experiment isn't done
+ */
+float RelayTuner::get_ultimate_period (void) const
+{
+    if (status != TUNE_DONE)
+    {
+        return 0;
+    }
+    return period_total / TUNE_MEASURE_CYCLES;
+}
+
+
+/** @brief   Return PID gains for the surface loop found from the experiment.
+ *  @details The Tyreus-Luyben rules give Kp = Ku / 2.2, an integral time of
+ *           2.2 Tu and a derivative time of Tu / 6.3.
+ *  @returns Gains in the units used by @c PIDBank, or all zero if the
+ *           experiment isn't done
+ */
+PIDGains RelayTuner::get_gains (void) const
+{
+    PIDGains gains = {0, 0, 0};
+    float Tu = get_ultimate_period ();
+    if (Tu > 0)
+    {
+        gains.Kp = get_ultimate_gain () / 2.2f;
+        gains.Ki = gains.Kp / (2.2f * Tu);
+        gains.Kd = gains.Kp * Tu / 6.3f;
+    }
+    return gains;
+}
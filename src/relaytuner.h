@@ -0,0 +1,108 @@
+/** @file    relaytuner.h
+ *  @brief   Headers for a relay-feedback autotuner for a surface position
+ *           loop.
+ *  @details The tuner replaces a surface's controller with a relay: the motor
+ *           is driven at a fixed duty cycle one way while the surface is
+ *           below the center angle and the other way while it is above. The
+ *           surface then swings steadily about the center. From the
+ *           amplitude @a a of the swing and the relay's duty cycle @a d, the
+ *           ultimate gain, at which a proportional controller would just
+ *           oscillate, is Ku = 4d / (pi a); the period of the swing is the
+ *           ultimate period Tu. PID gains are then found from Ku and Tu with
+ *           the Tyreus-Luyben rules, which give less overshoot than
+ *           Ziegler-Nichols.
+ *
+ *           A few swings are enough, so tuning a surface takes about a
+ *           second. The tuner gives up if the surface swings too far or the
+ *           swings don't settle in time.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#ifndef _RELAYTUNER_H_
+#define _RELAYTUNER_H_
+
+#include <Arduino.h>
+#include "gains.h"
+
+
+/// Number of swings allowed to settle before measuring begins
+#define TUNE_SETTLE_CYCLES 2
+
+/// Number of swings over which the amplitude and period are averaged
+#define TUNE_MEASURE_CYCLES 4
+
+
+/** @brief  The progress of a relay tuning experiment.
+ */
+enum TuneStatus : uint8_t
+{
+    TUNE_IDLE = 0,                      ///< Not started
+    TUNE_RUNNING,                       ///< Swinging the surface
+    TUNE_DONE,                          ///< Finished; the gains may be used
+    TUNE_FAILED                         ///< Swung too far or took too long
+};
+
+
+/** @brief   Class which runs a relay-feedback experiment on one surface.
+ *  @details The owner calls @c start(), then calls @c step() each time the
+ *           surface loop runs, giving it the surface angle and driving the
+ *           motor at the duty cycle it returns, until @c get_status() is no
+ *           longer @c TUNE_RUNNING.
+ */
+class RelayTuner
+{
+protected:
+    float relay_duty;                   ///< Duty cycle of the relay (%)
+    float hysteresis;                   ///< Angle past center before switching (deg)
+    float max_excursion;                ///< Largest safe angle from center (deg)
+    uint32_t timeout_us;                ///< Longest time the experiment may take
+
+    TuneStatus status;                  ///< Progress of the experiment
+    float center;                       ///< Angle about which to swing (deg)
+    bool drive_up;                      ///< Whether the relay is driving upward
+    uint32_t start_us;                  ///< Time the experiment began
+    uint32_t last_rise_us;              ///< Time the relay last switched upward
+    uint8_t cycles;                     ///< Number of swings so far
+    float high_angle;                   ///< Highest angle in this swing (deg)
+    float low_angle;                    ///< Lowest angle in this swing (deg)
+    float period_total;                 ///< Total of measured periods (ms)
+    float amplitude_total;              ///< Total of measured amplitudes (deg)
+
+public:
+    // Create a tuner with the given relay and safety limits
+    RelayTuner (float a_relay_duty = 40, float a_hysteresis = 1,
+                float a_max_excursion = 30, uint32_t a_timeout_ms = 4000);
+
+    // Begin an experiment about a given center angle
+    void start (float a_center, uint32_t time_us);
+
+    // Run the relay once and return the duty cycle for the motor
+    int16_t step (float angle, uint32_t time_us);
+
+    /// Return the progress of the experiment
+    TuneStatus get_status (void) const { return status; }
+
+    // Return the ultimate gain, in duty cycle percent per degree
+    float get_ultimate_gain (void) const;
+
+    // Return the ultimate period in milliseconds
+    float get_ultimate_period (void) const;
+
+    // Return PID gains for the surface loop found from the experiment
+    PIDGains get_gains (void) const;
+};
+
+
+/** @brief  The results of tuning every control surface's position loop.
+ */
+struct TuneResult
+{
+    TuneStatus status[SURFACE_AXES];    ///< Whether each surface was tuned
+    float ultimate_gain[SURFACE_AXES];  ///< Ultimate gains (%/deg)
+    float ultimate_period[SURFACE_AXES];    ///< Ultimate periods (ms)
+    PIDGains gains[SURFACE_AXES];       ///< Gains for the surface loop
+};
+
+#endif // _RELAYTUNER_H_
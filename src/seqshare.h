@@ -0,0 +1,304 @@
+/** @file    seqshare.h
+ *  @brief   Lock-free shared data item for one writer and many readers.
+ *  @details This file contains a template class for data which is written by
+ *           a single task (or ISR) and read by any number of other tasks.
+ *           Unlike @c Share<DataType>, which keeps its data in a one-item
+ *           FreeRTOS queue, a @c SeqShare<DataType> keeps two copies of the
+ *           data and a sequence counter. The writer fills the copy which
+ *           readers are not looking at, then publishes it by bumping the
+ *           counter; readers copy the newest item and check that the counter
+ *           did not move while they were copying. Neither side enters the
+ *           kernel, and readers never wait for a writer which has been
+ *           preempted in the middle of a @c put(), because the half-written
+ *           copy is never the one readers are directed to.
+ *
+ *  @author ME 507 Airheads, modeled on @c taskshare.h by JR Ridgely
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Added @c wait_for_update() so a reader can sleep until
+ *                      new data is published
+ *  @date   2026-Oct-16 Added @c get_if_updated() for settings read each loop
+ *  @copyright Released under the Lesser GNU Public License, version 2, as is
+ *    @c taskshare.h. */
+
+// This define prevents this .h file from being included more than once
+#ifndef _SEQSHARE_H_
+#define _SEQSHARE_H_
+
+#include <atomic>
+#include "baseshare.h"                      // Base class for shared data items
+#include <PrintStream.h>                    // Needed for endl
+
+
+/** @brief   Class for data shared between tasks without locks or queues.
+ *  @details This class has the same @c put(), @c get(), @c ISR_put() and
+ *           @c ISR_get() methods as @c Share<DataType>, so a share can be
+ *           switched from one type to the other by changing its declaration.
+ *           The difference is in how the data is protected. A sequence count
+ *           of completed writes selects which of two buffers holds the newest
+ *           data; the writer always fills the other buffer. A reader copies
+ *           the newest buffer, then re-reads the count. If the count changed,
+ *           the writer may have started to overwrite the copy being read, so
+ *           the reader tries again. A reader can only be made to retry by a
+ *           writer which has actually finished a write, so readers always
+ *           make progress, even on a single core where a high priority reader
+ *           has preempted a low priority writer.
+ *
+ *           @b Only @b one @b task @b or @b ISR @b may @b write to a
+ *           @c SeqShare. Two writers can interleave and corrupt the data;
+ *           use a @c Share<DataType> for data which is written from more than
+ *           one place, such as a state variable set both by a task and by
+ *           the web server.
+ *
+ *           Because the data is copied without a lock, @c DataType should be
+ *           a plain-old-data type (numbers, or a @c struct of numbers).
+ *
+ *           One task may sleep in @c wait_for_update() until new data is
+ *           published. The writer then wakes it with a task notification,
+ *           which is the only time a @c put() enters the kernel.
+ *
+ *           @section usage_seqshare Usage
+ *           @code{.cpp}
+ *           #include "seqshare.h"
+ *           ...
+ *           /// Latest reading from the moose antler sensor
+ *           SeqShare<float> antler ("Antler");
+ *           ...
+ *           antler.put (3.14);             // In the one writing task
+ *           ...
+ *           float reading = antler.get (); // In any reading task or ISR
+ *           @endcode
+ */
+template <class DataType> class SeqShare : public BaseShare
+{
+protected:
+    /// Two copies of the data; the newest is at index @c (sequence & 1)
+    DataType buffer[2];
+
+    /// The number of completed writes, which selects the newest buffer
+    std::atomic<uint32_t> sequence;
+
+    /// The task, if any, which is woken up when new data is put in the share
+    TaskHandle_t volatile waiting_task;
+
+    /** @brief   Copy data into the free buffer and publish it.
+     *  @param   new_data The data which is to be written
+     */
+    void publish (const DataType& new_data)
+    {
+        uint32_t next = sequence.load (std::memory_order_relaxed) + 1;
+
+        // Keep the previous publish ahead of the writes into the other buffer
+        std::atomic_thread_fence (std::memory_order_acq_rel);
+        buffer[next & 1] = new_data;
+
+        // Publish; readers which see the new count also see the new data
+        sequence.store (next, std::memory_order_release);
+        count_put ();
+    }
+
+public:
+    /** @brief   Construct a lock-free shared data item.
+     *  @details This constructor sets the write count to zero. As with a
+     *           @c Share, the data itself is @b not initialized.
+     *  @param   p_name A name to be shown in the list of task shares
+     *           (default @c NULL)
+     */
+    SeqShare<DataType> (const char* p_name = NULL) : BaseShare (p_name)
+    {
+        sequence.store (0, std::memory_order_relaxed);
+        waiting_task = NULL;
+    }
+
+    /** @brief   Put data into the shared data item.
+     *  @details This method copies the data into the buffer which readers are
+     *           not using, then publishes it by incrementing the sequence
+     *           count. If a task is waiting for an update, it is notified.
+     *           It must only be called by the single writer.
+     *  @param   new_data The data which is to be written
+     */
+    void put (DataType new_data)
+    {
+        publish (new_data);
+
+        TaskHandle_t task = waiting_task;
+        if (task != NULL)
+        {
+            xTaskNotifyGive (task);
+        }
+    }
+
+    /** @brief   Put data into the shared data item from within an ISR.
+     *  @details This is the same as @c put() except for the way in which a
+     *           waiting task is notified.
+     *  @param   new_data The data to be written into the shared data item
+     */
+    void ISR_put (DataType new_data)
+    {
+        publish (new_data);
+
+        TaskHandle_t task = waiting_task;
+        if (task != NULL)
+        {
+            BaseType_t wake_up = pdFALSE;
+            vTaskNotifyGiveFromISR (task, &wake_up);
+            portYIELD_FROM_ISR (wake_up);
+        }
+    }
+
+    /** @brief   Operator which inserts data into the share.
+     *  @details This operator checks whether it is in an ISR and calls
+     *           @c ISR_put() or @c put() to match.
+     *  @param   new_data The data which is to be put into the share
+     */
+    void operator << (DataType new_data)
+    {
+        if (CHECK_IF_IN_ISR ())
+        {
+            ISR_put (new_data);
+        }
+        else
+        {
+            put (new_data);
+        }
+    }
+
+    /** @brief   Read data from the shared data item into a variable.
+     *  @details This method copies the newest data and retries if the writer
+     *           published again while the copy was being made. It never
+     *           blocks and may be used within an ISR or outside one.
+     *  @param   recv_data A reference to the variable in which to put received
+     *           data
+     */
+    void get (DataType& recv_data)
+    {
+        uint32_t before;
+        uint32_t after;
+        do
+        {
+            before = sequence.load (std::memory_order_acquire);
+            recv_data = buffer[before & 1];
+
+            // Make sure the copy is finished before the count is checked
+            std::atomic_thread_fence (std::memory_order_acquire);
+            after = sequence.load (std::memory_order_relaxed);
+        }
+        while (before != after);
+
+        count_get ();
+    }
+
+    /** @brief   Read and return data from the shared data item.
+     *  @returns A copy of the newest data in the share
+     */
+    DataType get (void)
+    {
+        DataType return_this;
+        get (return_this);
+        return return_this;
+    }
+
+    /** @brief   Read data from the shared data item, from within an ISR.
+     *  @param   recv_data A reference to the variable in which to put received
+     *           data
+     */
+    void ISR_get (DataType& recv_data)
+    {
+        get (recv_data);
+    }
+
+    /** @brief   Read and return data from the shared data item, from within an
+     *           ISR.
+     *  @returns A copy of the newest data in the share
+     */
+    DataType ISR_get (void)
+    {
+        return get ();
+    }
+
+    /** @brief   Read data from the share into a variable.
+     *  @param   put_here A reference to the variable in which to put received
+     *           data
+     */
+    void operator >> (DataType& put_here)
+    {
+        get (put_here);
+    }
+
+    /** @brief   Return the number of times data has been put into the share.
+     *  @details A reader can save this count and compare it later to see if
+     *           new data has arrived without copying the data.
+     *  @returns The number of completed calls to @c put()
+     */
+    uint32_t count (void)
+    {
+        return sequence.load (std::memory_order_acquire);
+    }
+
+    /** @brief   Read data from the share only if it has changed.
+     *  @details This suits settings, such as gains, which a loop checks each
+     *           time it runs: the data is only copied when there's something
+     *           new, and the check never blocks.
+     *  @param   recv_data A reference to the variable which is overwritten
+     *           if there's newer data
+     *  @param   updates_seen The value of @c count() when the data was last
+     *           read, which is updated
+     *  @returns @c true if @c recv_data was overwritten with new data
+     */
+    bool get_if_updated (DataType& recv_data, uint32_t& updates_seen)
+    {
+        uint32_t updates = count ();
+        if (updates == updates_seen)
+        {
+            return false;
+        }
+        updates_seen = updates;
+        get (recv_data);
+        return true;
+    }
+
+    /** @brief   Sleep until new data is put into the share.
+     *  @details The calling task is woken by the next @c put() or @c ISR_put().
+     *           Data put in since the task last waited wakes it at once. As
+     *           with @c Share, only one task at a time should wait on a given
+     *           share, and the wakeup is a task notification, so a task
+     *           shouldn't use notifications for anything else while waiting.
+     *  @param   timeout The longest time to wait, in RTOS ticks (default:
+     *           forever)
+     *  @returns @c true if the task was woken by new data, @c false if the
+     *           wait timed out
+     */
+    bool wait_for_update (TickType_t timeout = portMAX_DELAY)
+    {
+        waiting_task = xTaskGetCurrentTaskHandle ();
+        return ulTaskNotifyTake (pdTRUE, timeout) > 0;
+    }
+
+    // Print the share's status within a list of all shares' statuses
+    void print_in_list (Print& printer);
+
+}; // class SeqShare<DataType>
+
+
+/** @brief   Print the name, type and statistics of this data item.
+ *  @details This method prints the share's name, a word showing that it is a
+ *           lock-free share, and its put/get statistics, then asks the next
+ *           item in the linked list of shares to do the same.
+ *  @param   printer Reference to a serial device on which to print the status
+ */
+template <class DataType>
+void SeqShare<DataType>::print_in_list (Print& printer)
+{
+    // Print this share's name and pad it to 16 characters
+    printer.printf ("%-16s%-10s%9s", name, "seqshare", "");
+
+    // Print the statistics and end the line
+    print_stats (printer);
+
+    // Call the next item
+    if (p_next != NULL)
+    {
+        p_next->print_in_list (printer);
+    }
+}
+
+#endif  // _SEQSHARE_H_
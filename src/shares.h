@@ -5,6 +5,11 @@
  *  @author JR Ridgely
  *  @author Damond Li edited file to be used for Airhead's ME507 Glider Project
  *  @date   2021-Oct-23 Original file
+ *  @date   2026-Oct-16 Added the controller gain share
+ *  @date   2026-Oct-16 Added the gain schedule and ground distance shares
+ *  @date   2026-Oct-16 Added the autotune result share
+ *  @date   2026-Oct-16 Added the state change share
+ *  @date   2026-Oct-16 Added the descent rate share
  *  @copyright (c) 2021 by JR Ridgely, released under the LGPL 3.0. 
  */
 
@@ -14,13 +19,29 @@
 
 #include "taskqueue.h"
 #include "taskshare.h"
+#include "seqshare.h"
+#include "attitude.h"
+#include "surfaces.h"
+#include "gains.h"
+#include "gainschedule.h"
+#include "relaytuner.h"
+#include "flightcontrol.h"
+#include "attitudefilter.h"
 
 extern Share<bool> near_ground;         ///< A share describing whether the glider is near the ground
 extern Share<uint8_t> tc_state;         ///< A share describing the state of the controller FSM
-extern Share<int16_t> rudder_duty;      ///< A share for the duty cycle for the rudder motor
-extern Share<int16_t> elev_duty;        ///< A share for the duty cycle for the elevator motor
-extern Share<float> yawC;               ///< A share for the current yaw
-extern Share<float> pitchC;             ///< A share for the current pitch
+extern SeqShare<SurfaceSetpoint> surface_setpoint; ///< A share for the surface angles wanted by the controller
+extern SeqShare<SurfaceState> surface_state;    ///< A share for the surface angles and motor duty cycles
+extern SeqShare<GainSet> controller_gains; ///< A share for controller gains set from the web page
+extern SeqShare<ScheduleSet> gain_schedules; ///< A share for gain schedules set from the web page
+extern SeqShare<MahonyGains> filter_gains; ///< A share for attitude filter gains set from the web page
+extern SeqShare<TuneResult> autotune_result; ///< A share for the results of autotuning the surface loop
+extern SeqShare<float> ground_distance; ///< A share for the height above the ground (cm)
+extern SeqShare<float> descent_rate;    ///< A share for the rate of descent (cm/s)
+extern SeqShare<AttitudeSample> attitude; ///< A share for the latest attitude sample from the IMU
+extern SeqShare<IMUStatus> imu_status;  ///< A share for the IMU's bus clock, failed raw reads and FIFO overruns
+extern SeqShare<TransitionLog> state_transitions; ///< A share for the controller's recent changes of state
+extern SeqShare<uint32_t> stale_samples; ///< A share for the number of active runs with no new IMU sample
 extern Share<bool> web_calibrate;       ///< A share for a calibration variable
 
 #endif // _SHARES_H_
\ No newline at end of file
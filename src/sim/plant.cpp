@@ -0,0 +1,180 @@
+/** @file    plant.cpp
+ *  @brief   Source code for a model of the glider, its control surfaces and
+ *           its sensors, used by the simulator.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#include "plant.h"
+
+/// Acceleration of gravity (m/s^2)
+#define GRAVITY 9.81f
+
+/// Degrees per radian
+#define DEG_PER_RAD (180.0f / (float)PI)
+
+
+/** @brief   Create a glider gliding at a given height and attitude.
+ *  @details The surfaces start centered, with the potentiometers zeroed.
+ *  @param   a_params The physical constants of the model
+ *  @param   a_noise How noisy and disturbed the run is
+ *  @param   seed Seed for the random numbers; the same seed gives the same run
+ *  @param   height Height of launch (m)
+ *  @param   pitch Pitch at launch (deg)
+ *  @param   roll Roll at launch (deg)
+ */
+GliderPlant::GliderPlant (const PlantParams& a_params, const PlantNoise& a_noise,
+                          uint32_t seed, float height, float pitch, float roll)
+    : params (a_params), noise (a_noise), random (seed),
+      gaussian (0, 1), uniform (0, 1)
+{
+    memset (&state, 0, sizeof (state));
+    for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
+    {
+        pot_zero[axis] = 0;
+    }
+    state.speed = params.trim_speed;
+    state.pitch = pitch;
+    state.roll = roll;
+    state.height = height;
+    imu_sequence = 0;
+}
+
+
+/** @brief   Move the model forward by a short time.
+ *  @details The model is integrated with Euler steps, which is accurate
+ *           enough if @c dt is a small fraction of the motor lag.
+ *  @param   dt The time step (s)
+ */
+void GliderPlant::step (float dt)
+{
+    // Motors and surfaces. A motor below its deadband stops
+    for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
+    {
+        float duty = state.duty[axis];
+        float target = (fabs (duty) < params.motor_deadband)
+                       ? 0 : params.surface_max_rate * duty / 100;
+        state.surface_rate[axis] += (target - state.surface_rate[axis])
+                                    * dt / params.motor_lag;
+        state.surface[axis] += state.surface_rate[axis] * dt;
+        if (fabs (state.surface[axis]) > params.surface_travel)
+        {
+            state.surface[axis] = (state.surface[axis] > 0)
+                                  ? params.surface_travel : -params.surface_travel;
+            state.surface_rate[axis] = 0;
+        }
+    }
+
+    // Gusts are random accelerations which wander with a correlation time
+    float gust_decay = dt / params.gust_time;
+    float gust_kick = noise.gust_strength * sqrt (2 * gust_decay);
+    state.pitch_gust += -state.pitch_gust * gust_decay + gust_kick * gaussian (random);
+    state.roll_gust += -state.roll_gust * gust_decay + gust_kick * gaussian (random);
+
+    // Control moments grow with the square of the airspeed
+    float pressure = (state.speed * state.speed)
+                     / (params.trim_speed * params.trim_speed);
+
+    float pitch_accel = params.pitch_control * pressure * state.surface[ELEVATOR_AXIS]
+                        - params.pitch_stiffness * (state.pitch - params.trim_pitch)
+                        - params.pitch_damping * state.pitch_rate
+                        + state.pitch_gust;
+    float yaw_accel = params.yaw_control * pressure * state.surface[RUDDER_AXIS]
+                      - params.yaw_damping * state.yaw_rate;
+    float roll_accel = params.dihedral * state.yaw_rate
+                       - params.roll_damping * state.roll_rate
+                       - params.roll_stiffness * state.roll
+                       + state.roll_gust;
+
+    state.pitch_rate += pitch_accel * dt;
+    state.pitch += state.pitch_rate * dt;
+    state.yaw_rate += yaw_accel * dt;
+    state.yaw += state.yaw_rate * dt;
+    state.roll_rate += roll_accel * dt;
+    state.roll += state.roll_rate * dt;
+
+    // The flight path is the pitch less the trimmed angle of attack. Drag is
+    // set so the trimmed glide holds its speed, and climbing costs speed
+    float path = (state.pitch - params.trim_alpha) / DEG_PER_RAD;
+    float trim_path = (params.trim_pitch - params.trim_alpha) / DEG_PER_RAD;
+    float drag = -GRAVITY * sin (trim_path) * pressure;
+    state.speed += (-GRAVITY * sin (path) - drag) * dt;
+    if (state.speed < 0)
+    {
+        state.speed = 0;
+    }
+    state.height += state.speed * sin (path) * dt;
+    state.distance += state.speed * cos (path) * dt;
+}
+
+
+/** @brief   Take an IMU sample.
+ *  @param   time_us The time of the sample (us)
+ *  @returns The sample, with noisy angles and rates
+ */
+AttitudeSample GliderPlant::read_imu (uint32_t time_us)
+{
+    AttitudeSample sample;
+    sample.sequence = ++imu_sequence;
+    sample.time_us = time_us;
+    sample.pitch = state.pitch + noise.imu_noise * gaussian (random);
+    sample.roll = state.roll + noise.imu_noise * gaussian (random);
+    sample.yaw = state.yaw + noise.imu_noise * gaussian (random);
+    sample.pitch_rate = state.pitch_rate;
+    sample.roll_rate = state.roll_rate;
+    sample.yaw_rate = state.yaw_rate;
+    return sample;
+}
+
+
+/** @brief   Read the ultrasonic sensor, in centimeters as the glider's sensor
+ *           does.
+ *  @returns The height with noise, no more than the sensor's range (cm)
+ */
+float GliderPlant::read_ultrasonic (void)
+{
+    float height = state.height + noise.ultrasonic_noise * gaussian (random);
+    if (height > params.ultrasonic_range)
+    {
+        height = params.ultrasonic_range;
+    }
+    return (height > 0) ? height * 100 : 0;
+}
+
+
+/** @brief   Read a surface potentiometer.
+ *  @details The reading has noise and the steps of the ADC. Now and then the
+ *           reading is wild, as when a wiper skips on a worn track.
+ *  @param   axis The surface
+ *  @returns The angle the potentiometer reads (deg)
+ */
+float GliderPlant::get_angle (uint8_t axis)
+{
+    float angle = state.surface[axis] - pot_zero[axis]
+                  + noise.pot_noise * gaussian (random);
+    if (noise.pot_glitch_rate > 0 && uniform (random) < noise.pot_glitch_rate)
+    {
+        angle += (uniform (random) - 0.5f) * 120;
+    }
+    return round (angle / params.pot_step) * params.pot_step;
+}
+
+
+/** @brief   Make a surface potentiometer read zero at the present angle.
+ *  @param   axis The surface
+ */
+void GliderPlant::zero (uint8_t axis)
+{
+    pot_zero[axis] = state.surface[axis];
+}
+
+
+/** @brief   Set a surface motor's duty cycle.
+ *  @param   axis The surface
+ *  @param   duty The duty cycle, from -100% to 100%
+ */
+void GliderPlant::set_duty (uint8_t axis, int16_t duty)
+{
+    state.duty[axis] = duty;
+}
@@ -0,0 +1,158 @@
+/** @file    plant.h
+ *  @brief   Headers for a model of the glider, its control surfaces and its
+ *           sensors, used by the simulator.
+ *  @details The model is simple enough to run thousands of times faster than
+ *           real time but has the features which matter to the controllers:
+ *
+ *           - Each control surface is moved by a DC motor whose speed follows
+ *             the duty cycle with a lag and which doesn't move at all below a
+ *             small duty cycle (static friction). The surface stops at its end
+ *             of travel. Its potentiometer reads the angle with noise, the
+ *             steps of a 12-bit ADC, and now and then a glitch.
+ *           - The glider flies at a trimmed glide angle, a little nose down
+ *             so the controller has work to do. The elevator pitches it
+ *             against a restoring moment and pitch damping. The rudder
+ *             yaws it, and the dihedral turns the yaw into roll. Both control
+ *             moments grow with the square of the airspeed. Pitching up trades
+ *             speed for height. Gusts push on pitch and roll.
+ *           - The IMU measures pitch and roll with noise, and the ultrasonic
+ *             sensor measures height with noise up to its maximum range.
+ *
+ *           Angles are in degrees, times in seconds, lengths in meters, except
+ *           where the glider's own sensors use other units.
+ *
+ *           All randomness comes from one generator seeded by the caller, so a
+ *           run with a given seed is always the same.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#ifndef _PLANT_H_
+#define _PLANT_H_
+
+#include <Arduino.h>
+#include <random>
+#include "surfaces.h"
+#include "surfaceio.h"
+#include "attitude.h"
+
+
+/** @brief  The physical constants of the model.
+ *  @details The defaults are rough values for the Airheads glider; they can
+ *           be changed for each run.
+ */
+struct PlantParams
+{
+    // Surfaces and their motors
+    float surface_max_rate = 300;       ///< Surface speed at 100% duty cycle (deg/s)
+    float motor_lag = 0.03;             ///< Time constant of the motor speed (s)
+    float motor_deadband = 8;           ///< Duty cycle below which a motor won't move (%)
+    float surface_travel = 45;          ///< Angle of the surface end stops (deg)
+    float pot_step = 270.0 / 4096;      ///< Smallest change a potentiometer reads (deg)
+
+    // Glider
+    float trim_speed = 8;               ///< Airspeed of a trimmed glide (m/s)
+    float trim_alpha = 4;               ///< Pitch less flight path angle in the glide (deg)
+    float trim_pitch = -3;              ///< Pitch held with the elevator centered (deg)
+    float pitch_control = 40;           ///< Pitch acceleration per degree of elevator (1/s^2)
+    float pitch_stiffness = 30;         ///< Restoring pitch acceleration per degree (1/s^2)
+    float pitch_damping = 8;            ///< Pitch damping (1/s)
+    float yaw_control = 10;             ///< Yaw acceleration per degree of rudder (1/s^2)
+    float yaw_damping = 3;              ///< Yaw damping (1/s)
+    float dihedral = 2;                 ///< Roll acceleration per unit yaw rate (1/s)
+    float roll_damping = 6;             ///< Roll damping (1/s)
+    float roll_stiffness = 2;           ///< Restoring roll acceleration per degree (1/s^2)
+    float gust_time = 0.5;              ///< Correlation time of gusts (s)
+
+    // Sensors
+    float ultrasonic_range = 4;         ///< Greatest height the ultrasonic sensor reads (m)
+};
+
+
+/** @brief  How noisy and disturbed a run is.
+ *  @details These are the things randomized from run to run by a Monte Carlo
+ *           study; all zero gives a perfectly calm run with perfect sensors.
+ */
+struct PlantNoise
+{
+    float imu_noise = 0.3;              ///< Standard deviation of IMU angles (deg)
+    float pot_noise = 0.2;              ///< Standard deviation of potentiometer readings (deg)
+    float pot_glitch_rate = 0;          ///< Chance that a potentiometer reading is wild
+    float ultrasonic_noise = 0.01;      ///< Standard deviation of heights (m)
+    float gust_strength = 0;            ///< Standard deviation of gust accelerations (deg/s^2)
+};
+
+
+/** @brief  Everything about the glider which changes as it flies.
+ */
+struct PlantState
+{
+    float surface[SURFACE_AXES];        ///< True surface angles (deg)
+    float surface_rate[SURFACE_AXES];   ///< Surface speeds (deg/s)
+    int16_t duty[SURFACE_AXES];         ///< Motor duty cycles (%)
+
+    float speed;                        ///< Airspeed (m/s)
+    float pitch;                        ///< Pitch angle (deg)
+    float pitch_rate;                   ///< Pitch rate (deg/s)
+    float roll;                         ///< Roll angle (deg)
+    float roll_rate;                    ///< Roll rate (deg/s)
+    float yaw;                          ///< Heading (deg)
+    float yaw_rate;                     ///< Yaw rate (deg/s)
+    float height;                       ///< Height of the sensors above the ground (m)
+    float distance;                     ///< Distance flown over the ground (m)
+
+    float pitch_gust;                   ///< Present gust pitch acceleration (deg/s^2)
+    float roll_gust;                    ///< Present gust roll acceleration (deg/s^2)
+};
+
+
+/** @brief   Class which models the glider, its surfaces and its sensors.
+ *  @details The surface loop reaches the model's motors and potentiometers
+ *           through the @c SurfaceIO interface, just as it reaches the real
+ *           ones on the glider.
+ */
+class GliderPlant : public SurfaceIO
+{
+protected:
+    PlantParams params;                 ///< Physical constants
+    PlantNoise noise;                   ///< Sensor noise and gusts
+    PlantState state;                   ///< Present state of the glider
+    float pot_zero[SURFACE_AXES];       ///< Angles at which the pots read zero (deg)
+    uint32_t imu_sequence;              ///< Number of IMU samples taken
+
+    std::mt19937 random;                ///< Source of all the randomness
+    std::normal_distribution<float> gaussian;       ///< Mean 0, deviation 1
+    std::uniform_real_distribution<float> uniform;  ///< From 0 to 1
+
+public:
+    // Create a glider gliding at a given height and attitude
+    GliderPlant (const PlantParams& a_params, const PlantNoise& a_noise,
+                 uint32_t seed, float height, float pitch, float roll);
+
+    // Move the model forward by a short time
+    void step (float dt);
+
+    /// Return the state of the model
+    const PlantState& get_state (void) const { return state; }
+
+    // Take an IMU sample
+    AttitudeSample read_imu (uint32_t time_us);
+
+    // Read the ultrasonic sensor, in centimeters as the glider's sensor does
+    float read_ultrasonic (void);
+
+    /// Return whether the glider has touched the ground
+    bool landed (void) const { return state.height <= 0; }
+
+    // Read a surface potentiometer
+    float get_angle (uint8_t axis);
+
+    // Make a surface potentiometer read zero at the present angle
+    void zero (uint8_t axis);
+
+    // Set a surface motor's duty cycle
+    void set_duty (uint8_t axis, int16_t duty);
+};
+
+#endif // _PLANT_H_
@@ -0,0 +1,161 @@
+/** @file    sim_main.cpp
+ *  @brief   Program which flies simulated flights from the command line.
+ *  @details Build with @c "pio run -e native_sim" and run
+ *           @c .pio/build/native_sim/program with any of these options:
+ *
+ *           - @c --seed @a n     Seed of the first flight (1)
+ *           - @c --runs @a n     Number of flights, with seeds counting up (1)
+ *           - @c --duration @a s Longest flight (30 s)
+ *           - @c --height @a m   Launch height (6 m)
+ *           - @c --pitch @a deg  Pitch at launch (0)
+ *           - @c --roll @a deg   Roll at launch (5)
+ *           - @c --gusts @a x    Standard deviation of gusts (0 deg/s^2)
+ *           - @c --glitches @a p Chance of a wild potentiometer reading (0)
+ *           - @c --csv @a file   Write the first flight's trace as text
+ *           - @c --bin @a file   Write the first flight's trace in binary
+ *
+ *           One line of results is printed for each flight, followed by how
+ *           many times faster than real time the flights ran.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include <chrono>
+#include "simulation.h"
+
+
+/** @brief   Print how to use the program.
+ */
+static void usage (void)
+{
+    fprintf (stderr, "Usage: program [--seed n] [--runs n] [--duration s] "
+                     "[--height m] [--pitch deg] [--roll deg] [--gusts x] "
+                     "[--glitches p] [--csv file] [--bin file]\n");
+}
+
+
+/** @brief   Read the options, fly the flights and print the results.
+ *  @param   argc Number of command line arguments
+ *  @param   argv The command line arguments
+ *  @returns 0 if all went well, 1 for a bad option or file
+ */
+int main (int argc, char** argv)
+{
+    SimConfig config;
+    uint32_t runs = 1;
+    const char* csv_name = nullptr;
+    const char* bin_name = nullptr;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (arg + 1 >= argc)
+        {
+            usage ();
+            return 1;
+        }
+        const char* option = argv[arg];
+        const char* value = argv[++arg];
+        if (!strcmp (option, "--seed"))
+        {
+            config.seed = strtoul (value, nullptr, 0);
+        }
+        else if (!strcmp (option, "--runs"))
+        {
+            runs = strtoul (value, nullptr, 0);
+        }
+        else if (!strcmp (option, "--duration"))
+        {
+            config.duration = strtof (value, nullptr);
+        }
+        else if (!strcmp (option, "--height"))
+        {
+            config.launch_height = strtof (value, nullptr);
+        }
+        else if (!strcmp (option, "--pitch"))
+        {
+            config.launch_pitch = strtof (value, nullptr);
+        }
+        else if (!strcmp (option, "--roll"))
+        {
+            config.launch_roll = strtof (value, nullptr);
+        }
+        else if (!strcmp (option, "--gusts"))
+        {
+            config.noise.gust_strength = strtof (value, nullptr);
+        }
+        else if (!strcmp (option, "--glitches"))
+        {
+            config.noise.pot_glitch_rate = strtof (value, nullptr);
+        }
+        else if (!strcmp (option, "--csv"))
+        {
+            csv_name = value;
+        }
+        else if (!strcmp (option, "--bin"))
+        {
+            bin_name = value;
+        }
+        else
+        {
+            usage ();
+            return 1;
+        }
+    }
+
+    // Only the first flight is traced
+    FILE* p_file = nullptr;
+    SimTrace* p_trace = nullptr;
+    if (csv_name || bin_name)
+    {
+        p_file = fopen (csv_name ? csv_name : bin_name, csv_name ? "w" : "wb");
+        if (!p_file)
+        {
+            perror (csv_name ? csv_name : bin_name);
+            return 1;
+        }
+        if (csv_name)
+        {
+            p_trace = new CsvTrace (p_file);
+        }
+        else
+        {
+            p_trace = new BinaryTrace (p_file);
+        }
+    }
+
+    printf ("seed,landed,flight_s,active_s,settling_s,overshoot_deg,"
+            "max_roll_deg,touchdown_pitch_deg,touchdown_sink_mps,"
+            "touchdown_speed_mps,distance_m,stale\n");
+
+    double simulated = 0;
+    auto start = std::chrono::steady_clock::now ();
+    for (uint32_t run = 0; run < runs; run++)
+    {
+        SimConfig flight = config;
+        flight.seed = config.seed + run;
+        SimResult result = Simulation (flight).run (run == 0 ? p_trace : nullptr);
+        simulated += result.flight_time;
+
+        printf ("%u,%d,%.3f,%.2f,%.3f,%.2f,%.2f,%.2f,%.3f,%.2f,%.1f,%u\n",
+                flight.seed, result.landed, result.flight_time,
+                result.active_time, result.settling_time, result.overshoot,
+                result.max_roll, result.touchdown_pitch, result.touchdown_sink,
+                result.touchdown_speed, result.distance,
+                result.stale_samples);
+    }
+    auto stop = std::chrono::steady_clock::now ();
+    double wall = std::chrono::duration<double> (stop - start).count ();
+
+    fprintf (stderr, "%.1f s flown in %.3f s, %.0f times real time\n",
+             simulated, wall, simulated / wall);
+
+    delete p_trace;
+    if (p_file)
+    {
+        fclose (p_file);
+    }
+    return 0;
+}
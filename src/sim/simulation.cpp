@@ -0,0 +1,206 @@
+/** @file    simulation.cpp
+ *  @brief   Source code for a simulated flight which runs the glider's own
+ *           control code against a model of the glider.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Rate of descent found from the heights; cruise ends at the flare
+ */
+
+#include "simulation.h"
+
+
+/** @brief   Write the header line of a CSV trace to an open file.
+ *  @param   a_p_file The file, which the caller opens and closes
+ */
+CsvTrace::CsvTrace (FILE* a_p_file)
+    : p_file (a_p_file)
+{
+    fprintf (p_file, "time_s,state,height_m,speed_mps,pitch_deg,roll_deg,"
+                     "rudder_set_deg,elevator_set_deg,rudder_deg,elevator_deg,"
+                     "rudder_duty,elevator_duty\n");
+}
+
+
+/** @brief   Write one line of a CSV trace.
+ *  @param   record The line to be written
+ */
+void CsvTrace::write (const SimRecord& record)
+{
+    fprintf (p_file, "%.3f,%u,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.0f,%.0f\n",
+             record.time_us * 1e-6, (unsigned)record.state, record.height,
+             record.speed, record.pitch, record.roll,
+             record.setpoint[RUDDER_AXIS], record.setpoint[ELEVATOR_AXIS],
+             record.surface[RUDDER_AXIS], record.surface[ELEVATOR_AXIS],
+             record.duty[RUDDER_AXIS], record.duty[ELEVATOR_AXIS]);
+}
+
+
+/** @brief   Write the header of a binary trace to an open file.
+ *  @param   a_p_file The file, opened in binary mode, which the caller opens
+ *           and closes
+ */
+BinaryTrace::BinaryTrace (FILE* a_p_file)
+    : p_file (a_p_file)
+{
+    const uint32_t record_size = sizeof (SimRecord);
+    fwrite ("AIRHSIM1", 1, 8, p_file);
+    fwrite (&record_size, sizeof (record_size), 1, p_file);
+}
+
+
+/** @brief   Write one record of a binary trace.
+ *  @param   record The record to be written
+ */
+void BinaryTrace::write (const SimRecord& record)
+{
+    fwrite (&record, sizeof (record), 1, p_file);
+}
+
+
+/** @brief   Fly once, saving a trace if one is given.
+ *  @details Each step of the model, the sensors and control code which are
+ *           due are run first, as the tasks would have run them, then the
+ *           model is moved forward to the next step. The figures in the
+ *           result are measured from the model's true state rather than the
+ *           noisy sensors. In the cruise the controller holds zero pitch and
+ *           roll, so the errors are the angles themselves.
+ *  @param   p_trace Pointer to the trace to write, or @c nullptr for none
+ *  @returns Figures which say how well the flight went. The times are -1 if
+ *           the controller never took over
+ */
+SimResult Simulation::run (SimTrace* p_trace)
+{
+    GliderPlant plant (config.plant, config.noise, config.seed,
+                       config.launch_height, config.launch_pitch,
+                       config.launch_roll);
+
+    // The control code, set up as the tasks set it up
+    FlightController controller (SIM_IMU_PERIOD / 1000.0f);
+    SurfaceLoop surface_loop (SIM_SURFACE_PERIOD / 1000.0f);
+    controller.set_gains (config.gains);
+    controller.set_schedules (config.schedules);
+    surface_loop.set_gains (config.gains);
+    surface_loop.begin (plant);
+
+    SurfaceSetpoint setpoint = controller.get_setpoint ();
+    SurfaceState surfaces;
+    memset (&surfaces, 0, sizeof (surfaces));
+    ControllerInputs inputs;
+    inputs.elapsed_ms = SIM_IMU_PERIOD / 1000;
+    inputs.command = STATE_WAIT_FOR_LAUNCH;     // As if armed from the web page
+    inputs.tune_finished = false;
+
+    DescentEstimator descent;
+
+    SimResult result;
+    memset (&result, 0, sizeof (result));
+    result.active_time = -1;
+    result.settling_time = -1;
+
+    bool cruising = false;              // Controlled and not yet near the ground
+    uint32_t active_us = 0;             // Time at which the controller took over
+    uint32_t unsettled_us = 0;          // Last time the attitude was out of the band
+    float start_error = 0;              // Pitch when the controller took over
+
+    const float dt = SIM_PHYSICS_PERIOD * 1e-6f;
+    const uint32_t end_us = (uint32_t)(config.duration * 1e6f);
+    uint32_t time_us;
+    for (time_us = 0; time_us < end_us; time_us += SIM_PHYSICS_PERIOD)
+    {
+        if (time_us % SIM_ULTRASONIC_PERIOD == 0)
+        {
+            inputs.height = plant.read_ultrasonic ();
+            inputs.descent_rate = descent.update (inputs.height, time_us / 1000);
+            inputs.near_ground = inputs.height < NEAR_GROUND_DISTANCE;
+        }
+
+        // The controller runs on each new IMU sample
+        if (time_us % SIM_IMU_PERIOD == 0)
+        {
+            inputs.sample = plant.read_imu (time_us);
+            inputs.time_ms = time_us / 1000;
+            if (controller.run (inputs))
+            {
+                setpoint = controller.get_setpoint ();
+            }
+            inputs.command = STATE_NO_COMMAND;
+
+            const PlantState& state = plant.get_state ();
+            if (result.active_time < 0 && controller.get_state () == STATE_ACTIVE)
+            {
+                result.active_time = time_us * 1e-6f;
+                active_us = time_us;
+                unsettled_us = time_us;
+                start_error = state.pitch;
+                cruising = true;
+            }
+            if (cruising && flare_pitch (inputs.height, inputs.descent_rate) > 0)
+            {
+                cruising = false;
+            }
+            if (cruising)
+            {
+                if (fabs (state.pitch) > SIM_SETTLE_BAND
+                    || fabs (state.roll) > SIM_SETTLE_BAND)
+                {
+                    unsettled_us = time_us;
+                }
+                float past = (start_error > 0) ? -state.pitch : state.pitch;
+                if (past > result.overshoot)
+                {
+                    result.overshoot = past;
+                }
+            }
+            if (result.active_time >= 0 && fabs (state.roll) > result.max_roll)
+            {
+                result.max_roll = fabs (state.roll);
+            }
+
+            if (p_trace)
+            {
+                SimRecord record;
+                record.time_us = time_us;
+                record.state = controller.get_state ();
+                record.height = state.height;
+                record.speed = state.speed;
+                record.pitch = state.pitch;
+                record.roll = state.roll;
+                for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
+                {
+                    record.setpoint[axis] = setpoint.angle[axis];
+                    record.surface[axis] = state.surface[axis];
+                    record.duty[axis] = state.duty[axis];
+                }
+                p_trace->write (record);
+            }
+        }
+
+        if (time_us % SIM_SURFACE_PERIOD == 0)
+        {
+            surface_loop.run (plant, setpoint, time_us, surfaces);
+        }
+
+        float last_height = plant.get_state ().height;
+        plant.step (dt);
+        if (plant.landed ())
+        {
+            const PlantState& state = plant.get_state ();
+            result.landed = true;
+            result.touchdown_pitch = state.pitch;
+            result.touchdown_sink = (last_height - state.height) / dt;
+            result.touchdown_speed = state.speed;
+            time_us += SIM_PHYSICS_PERIOD;
+            break;
+        }
+    }
+
+    result.flight_time = time_us * 1e-6f;
+    result.distance = plant.get_state ().distance;
+    result.stale_samples = controller.get_stale_samples ();
+    if (result.active_time >= 0)
+    {
+        result.settling_time = (unsettled_us - active_us) * 1e-6f;
+    }
+    return result;
+}
@@ -0,0 +1,171 @@
+/** @file    simulation.h
+ *  @brief   Headers for a simulated flight which runs the glider's own
+ *           control code against a model of the glider.
+ *  @details A flight runs in simulated time rather than real time: the model
+ *           is moved forward in small steps and the control code is called
+ *           whenever the task which runs it would have been, so a flight of
+ *           several seconds takes a millisecond or so. The @c FlightController
+ *           runs on each IMU sample and the @c SurfaceLoop at
+ *           @c SIM_SURFACE_PERIOD, as they do in the tasks on the ESP32, and
+ *           the ultrasonic sensor is read at the rate of its task.
+ *
+ *           Each flight starts in state 1 at the launch height, so the
+ *           controller waits for the launch delay, holds the attitude, flares
+ *           near the ground, and ends when the glider touches down or the
+ *           time runs out. The result holds figures which say how well the
+ *           controllers did; a trace of the whole flight can be written as
+ *           well.
+ *
+ *           A @c Simulation has no globals, so several may be run at once in
+ *           different threads.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Cruise figures end where the flare begins
+ */
+
+#ifndef _SIMULATION_H_
+#define _SIMULATION_H_
+
+#include <Arduino.h>
+#include "plant.h"
+#include "flightcontrol.h"
+#include "surfaceloop.h"
+
+
+/// Time step of the model (us)
+#define SIM_PHYSICS_PERIOD 500
+
+/// Time between runs of the surface loop, as at 500 Hz on the ESP32 (us)
+#define SIM_SURFACE_PERIOD 2000
+
+/// Time between IMU samples, each of which runs the controller (us)
+#define SIM_IMU_PERIOD 10000
+
+/// Time between readings of the ultrasonic sensor (us)
+#define SIM_ULTRASONIC_PERIOD 100000
+
+/// Pitch and roll errors within which the attitude counts as settled (deg)
+#define SIM_SETTLE_BAND 2
+
+
+/** @brief  Everything which sets up one simulated flight.
+ */
+struct SimConfig
+{
+    uint32_t seed = 1;                  ///< Seed for the model's random numbers
+    float duration = 30;                ///< Longest flight simulated (s)
+    float launch_height = 6;            ///< Height of the sensors at launch (m)
+    float launch_pitch = 0;             ///< Pitch at launch (deg)
+    float launch_roll = 5;              ///< Roll at launch (deg)
+    PlantParams plant;                  ///< Physical constants of the model
+    PlantNoise noise;                   ///< Sensor noise and gusts
+    GainSet gains = DEFAULT_GAINS;      ///< Gains for both loops
+    ScheduleSet schedules = DEFAULT_SCHEDULES;  ///< Attitude gain schedules
+};
+
+
+/** @brief  Figures which say how well a simulated flight went.
+ *  @details The settling time and overshoot are measured over the cruise,
+ *           from when the controller takes over until the flare begins.
+ *           Times are from launch unless stated.
+ */
+struct SimResult
+{
+    bool landed;                        ///< Whether the glider touched down in time
+    float flight_time;                  ///< Time from launch to touchdown (s)
+    float active_time;                  ///< Time at which the controller took over (s)
+    float settling_time;                ///< Time after taking over until the pitch
+                                        ///< and roll stayed within the band (s)
+    float overshoot;                    ///< Largest pitch past the setpoint on the
+                                        ///< far side from the starting error (deg)
+    float max_roll;                     ///< Largest roll once controlled (deg)
+    float touchdown_pitch;              ///< Pitch at touchdown (deg)
+    float touchdown_sink;               ///< Rate of descent at touchdown (m/s)
+    float touchdown_speed;              ///< Airspeed at touchdown (m/s)
+    float distance;                     ///< Distance flown (m)
+    uint32_t stale_samples;             ///< Controller runs with no new IMU sample
+};
+
+
+/** @brief  One line of a flight's trace, written at each IMU sample.
+ */
+struct SimRecord
+{
+    uint32_t time_us;                   ///< Time since launch (us)
+    uint32_t state;                     ///< The controller's state
+    float height;                       ///< True height (m)
+    float speed;                        ///< Airspeed (m/s)
+    float pitch;                        ///< True pitch (deg)
+    float roll;                         ///< True roll (deg)
+    float setpoint[SURFACE_AXES];       ///< Surface angles wanted (deg)
+    float surface[SURFACE_AXES];        ///< True surface angles (deg)
+    float duty[SURFACE_AXES];           ///< Motor duty cycles (%)
+};
+
+
+/** @brief   Base class for something which saves a flight's trace.
+ */
+class SimTrace
+{
+public:
+    virtual ~SimTrace (void) { }
+
+    /// Save one line of the trace
+    virtual void write (const SimRecord& record) = 0;
+};
+
+
+/** @brief   Trace which writes comma separated text with a header line, for
+ *           spreadsheets and plotting scripts.
+ */
+class CsvTrace : public SimTrace
+{
+protected:
+    FILE* p_file;                       ///< File to which the trace is written
+
+public:
+    // Write the header line to an open file
+    CsvTrace (FILE* a_p_file);
+
+    // Write one line of the trace
+    void write (const SimRecord& record);
+};
+
+
+/** @brief   Trace which writes records in binary, which is smaller and
+ *           quicker than text for long sweeps.
+ *  @details The file begins with the eight characters @c "AIRHSIM1" and a
+ *           32-bit count of bytes per record, then holds @c SimRecord
+ *           structures one after another in the host's byte order.
+ */
+class BinaryTrace : public SimTrace
+{
+protected:
+    FILE* p_file;                       ///< File to which the trace is written
+
+public:
+    // Write the file header to an open file
+    BinaryTrace (FILE* a_p_file);
+
+    // Write one record of the trace
+    void write (const SimRecord& record);
+};
+
+
+/** @brief   Class which flies the control code against a model of the glider.
+ */
+class Simulation
+{
+protected:
+    SimConfig config;                   ///< How the flight is set up
+
+public:
+    /// Set up a flight
+    Simulation (const SimConfig& a_config) : config (a_config) { }
+
+    // Fly once, saving a trace if one is given
+    SimResult run (SimTrace* p_trace = nullptr);
+};
+
+#endif // _SIMULATION_H_
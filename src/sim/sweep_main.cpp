@@ -0,0 +1,469 @@
+/** @file    sweep_main.cpp
+ *  @brief   Program which searches for good controller gains by flying many
+ *           simulated flights at once on all of a PC's cores.
+ *  @details Each candidate set of gains for the four controllers is flown in
+ *           a number of trials. In each trial the sensor noise, potentiometer
+ *           glitches, gusts and launch attitude are drawn at random. Every
+ *           gain set is flown in the same trials, so the sets are compared
+ *           fairly, and the same seed always gives the same results. Each
+ *           flight is scored from its settling time, overshoot and pitch at
+ *           touchdown, a flight which doesn't take over and touch down scores
+ *           @c SWEEP_FAILED_SCORE, and the gain sets are ranked by their mean
+ *           score. The flights run as separate jobs on a @c ThreadPool.
+ *
+ *           Build with @c "pio run -e native_sweep" and run
+ *           @c .pio/build/native_sweep/program with any of these options:
+ *
+ *           - @c --param @a name.gain=low:high[:steps] Sweep one gain, where
+ *             @a name is @c yaw2rudder, @c pitch2elev, @c rudder2duty or
+ *             @c elev2duty, as on the web page, and @a gain is @c kp, @c ki
+ *             or @c kd. May be given for several gains; steps default to 5.
+ *             With no @c --param the four proportional gains are swept
+ *           - @c --random @a n   Draw @a n gain sets at random from the
+ *             ranges rather than sweeping a grid
+ *           - @c --trials @a n   Flights per gain set (20)
+ *           - @c --seed @a n     Seed for the trials and random gain sets (1)
+ *           - @c --threads @a n  Threads to use (one per core)
+ *           - @c --top @a n      Number of the best gain sets to print (10)
+ *           - @c --weights @a s,o,t Score per second of settling, per degree
+ *             of overshoot and per degree of touchdown pitch away from
+ *             @c FLARE_PITCH (1,0.5,0.2)
+ *           - @c --out @a file   Write every gain set's figures, best first
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "simulation.h"
+#include "threadpool.h"
+
+
+/// Score of a flight in which the controller never took over or the glider
+/// never touched down
+#define SWEEP_FAILED_SCORE 100
+
+/// Largest number of gain sets in a grid
+#define SWEEP_MAX_SETS 1000000
+
+
+/// Names of the controllers, in the order of the web page's table
+static const char* const CONTROLLER_NAMES[] =
+    {"yaw2rudder", "pitch2elev", "rudder2duty", "elev2duty"};
+
+/// Names of the gains of each controller
+static const char* const GAIN_NAMES[] = {"kp", "ki", "kd"};
+
+
+/** @brief  One gain being swept and its range.
+ */
+struct SweepParam
+{
+    uint8_t controller;                 ///< Index into @c CONTROLLER_NAMES
+    uint8_t gain;                       ///< Index into @c GAIN_NAMES
+    float low;                          ///< Smallest value tried
+    float high;                         ///< Largest value tried
+    uint32_t steps;                     ///< Number of values in a grid
+};
+
+
+/** @brief  How much each figure of a flight counts against it.
+ */
+struct SweepWeights
+{
+    float settling = 1;                 ///< Per second of settling time
+    float overshoot = 0.5;              ///< Per degree of overshoot
+    float touchdown = 0.2;              ///< Per degree of touchdown pitch error
+};
+
+
+/** @brief  The figures of one gain set over all its trials.
+ */
+struct SweepEntry
+{
+    GainSet gains;                      ///< The gains flown
+    float score;                        ///< Mean score; lower is better
+    float worst;                        ///< Worst score of any trial
+    float settling;                     ///< Mean settling time (s)
+    float overshoot;                    ///< Mean overshoot (deg)
+    float touchdown_pitch;              ///< Mean pitch at touchdown (deg)
+    uint32_t failures;                  ///< Trials which scored as failed
+};
+
+
+/** @brief   Find one gain of one controller in a gain set.
+ *  @param   gains The gain set
+ *  @param   controller Index into @c CONTROLLER_NAMES
+ *  @param   gain Index into @c GAIN_NAMES
+ *  @returns A reference to the gain
+ */
+static float& gain_ref (GainSet& gains, uint8_t controller, uint8_t gain)
+{
+    PIDGains& pid = (controller < 2) ? gains.attitude[controller % 2]
+                                     : gains.surface[controller % 2];
+    return (gain == 0) ? pid.Kp : (gain == 1) ? pid.Ki : pid.Kd;
+}
+
+
+/** @brief   Read a @c --param option such as @c "pitch2elev.kp=0.5:3:6".
+ *  @param   text The option's value
+ *  @param   param Set to the gain and its range
+ *  @returns @c true if the text made sense
+ */
+static bool parse_param (const char* text, SweepParam& param)
+{
+    const char* p_dot = strchr (text, '.');
+    const char* p_equals = strchr (text, '=');
+    if (!p_dot || !p_equals || p_equals < p_dot)
+    {
+        return false;
+    }
+
+    param.controller = 0xFF;
+    for (uint8_t index = 0; index < 4; index++)
+    {
+        if (strlen (CONTROLLER_NAMES[index]) == (size_t)(p_dot - text)
+            && !strncmp (text, CONTROLLER_NAMES[index], p_dot - text))
+        {
+            param.controller = index;
+        }
+    }
+    param.gain = 0xFF;
+    for (uint8_t index = 0; index < 3; index++)
+    {
+        if (strlen (GAIN_NAMES[index]) == (size_t)(p_equals - p_dot - 1)
+            && !strncmp (p_dot + 1, GAIN_NAMES[index], p_equals - p_dot - 1))
+        {
+            param.gain = index;
+        }
+    }
+
+    param.steps = 5;
+    int count = sscanf (p_equals + 1, "%f:%f:%u", &param.low, &param.high,
+                        &param.steps);
+    return param.controller != 0xFF && param.gain != 0xFF && count >= 2
+           && param.steps > 0;
+}
+
+
+/** @brief   Set up the random parts of one trial.
+ *  @details The ranges go from perfect sensors and still air to somewhat
+ *           worse than has been seen in the glider's test flights.
+ *  @param   random The generator from which the trial is drawn
+ *  @returns The trial's configuration, with the default gains
+ */
+static SimConfig make_trial (std::mt19937& random)
+{
+    std::uniform_real_distribution<float> uniform (0, 1);
+    std::normal_distribution<float> gaussian (0, 1);
+
+    SimConfig config;
+    config.seed = random ();
+    config.noise.imu_noise = 0.6f * uniform (random);
+    config.noise.pot_noise = 0.4f * uniform (random);
+    config.noise.pot_glitch_rate = 0.002f * uniform (random);
+    config.noise.ultrasonic_noise = 0.02f * uniform (random);
+    config.noise.gust_strength = 40 * uniform (random);
+    config.launch_height = 5 + 2 * uniform (random);
+    config.launch_pitch = 5 * gaussian (random);
+    config.launch_roll = 5 * gaussian (random);
+    return config;
+}
+
+
+/** @brief   Score one flight; lower is better.
+ *  @param   result The figures from the flight
+ *  @param   weights How much each figure counts
+ *  @returns The score
+ */
+static float score_flight (const SimResult& result, const SweepWeights& weights)
+{
+    if (!result.landed || result.active_time < 0)
+    {
+        return SWEEP_FAILED_SCORE;
+    }
+    return weights.settling * result.settling_time
+           + weights.overshoot * result.overshoot
+           + weights.touchdown * fabs (result.touchdown_pitch - FLARE_PITCH);
+}
+
+
+/** @brief   Print one gain set's figures and gains as a line of CSV.
+ *  @param   p_file The file to print to
+ *  @param   rank The gain set's place, counting from 1
+ *  @param   entry The gain set's figures
+ */
+static void print_entry (FILE* p_file, uint32_t rank, SweepEntry& entry)
+{
+    fprintf (p_file, "%u,%.4f,%.3f,%.3f,%.2f,%.2f,%u", rank, entry.score,
+             entry.worst, entry.settling, entry.overshoot,
+             entry.touchdown_pitch, entry.failures);
+    for (uint8_t controller = 0; controller < 4; controller++)
+    {
+        for (uint8_t gain = 0; gain < 3; gain++)
+        {
+            fprintf (p_file, ",%g", gain_ref (entry.gains, controller, gain));
+        }
+    }
+    fprintf (p_file, "\n");
+}
+
+
+/** @brief   Print the header line which goes with @c print_entry().
+ *  @param   p_file The file to print to
+ */
+static void print_header (FILE* p_file)
+{
+    fprintf (p_file, "rank,score,worst,settling_s,overshoot_deg,"
+                     "touchdown_pitch_deg,failures");
+    for (uint8_t controller = 0; controller < 4; controller++)
+    {
+        for (uint8_t gain = 0; gain < 3; gain++)
+        {
+            fprintf (p_file, ",%s.%s", CONTROLLER_NAMES[controller],
+                     GAIN_NAMES[gain]);
+        }
+    }
+    fprintf (p_file, "\n");
+}
+
+
+/** @brief   Print how to use the program.
+ */
+static void usage (void)
+{
+    fprintf (stderr, "Usage: program [--param name.gain=low:high[:steps]]... "
+                     "[--random n] [--trials n] [--seed n] [--threads n] "
+                     "[--top n] [--weights s,o,t] [--out file]\n");
+}
+
+
+/** @brief   Read the options, fly every gain set in every trial and print
+ *           the best gain sets.
+ *  @param   argc Number of command line arguments
+ *  @param   argv The command line arguments
+ *  @returns 0 if all went well, 1 for a bad option or file
+ */
+int main (int argc, char** argv)
+{
+    std::vector<SweepParam> params;
+    SweepWeights weights;
+    uint32_t random_sets = 0;
+    uint32_t trial_count = 20;
+    uint32_t seed = 1;
+    uint32_t thread_count = 0;
+    uint32_t top = 10;
+    const char* out_name = nullptr;
+
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (arg + 1 >= argc)
+        {
+            usage ();
+            return 1;
+        }
+        const char* option = argv[arg];
+        const char* value = argv[++arg];
+        SweepParam param;
+        if (!strcmp (option, "--param") && parse_param (value, param))
+        {
+            params.push_back (param);
+        }
+        else if (!strcmp (option, "--random"))
+        {
+            random_sets = strtoul (value, nullptr, 0);
+        }
+        else if (!strcmp (option, "--trials"))
+        {
+            trial_count = strtoul (value, nullptr, 0);
+        }
+        else if (!strcmp (option, "--seed"))
+        {
+            seed = strtoul (value, nullptr, 0);
+        }
+        else if (!strcmp (option, "--threads"))
+        {
+            thread_count = strtoul (value, nullptr, 0);
+        }
+        else if (!strcmp (option, "--top"))
+        {
+            top = strtoul (value, nullptr, 0);
+        }
+        else if (!strcmp (option, "--weights")
+                 && sscanf (value, "%f,%f,%f", &weights.settling,
+                            &weights.overshoot, &weights.touchdown) == 3)
+        {
+        }
+        else if (!strcmp (option, "--out"))
+        {
+            out_name = value;
+        }
+        else
+        {
+            usage ();
+            return 1;
+        }
+    }
+    if (trial_count == 0)
+    {
+        usage ();
+        return 1;
+    }
+
+    // By default, sweep the proportional gain of each controller
+    if (params.empty ())
+    {
+        params.push_back ({0, 0, 0.5, 3, 5});
+        params.push_back ({1, 0, 0.5, 3, 5});
+        params.push_back ({2, 0, 1, 8, 5});
+        params.push_back ({3, 0, 1, 8, 5});
+    }
+
+    // Make the gain sets, either every point of the grid or random points
+    std::mt19937 random (seed);
+    std::vector<SweepEntry> entries;
+    if (random_sets)
+    {
+        std::uniform_real_distribution<float> uniform (0, 1);
+        entries.resize (random_sets);
+        for (SweepEntry& entry : entries)
+        {
+            entry.gains = DEFAULT_GAINS;
+            for (const SweepParam& param : params)
+            {
+                gain_ref (entry.gains, param.controller, param.gain)
+                    = param.low + (param.high - param.low) * uniform (random);
+            }
+        }
+    }
+    else
+    {
+        uint64_t total = 1;
+        for (const SweepParam& param : params)
+        {
+            total *= param.steps;
+            if (total > SWEEP_MAX_SETS)
+            {
+                fprintf (stderr, "More than %u gain sets; use --random\n",
+                         SWEEP_MAX_SETS);
+                return 1;
+            }
+        }
+        entries.resize (total);
+        for (uint32_t index = 0; index < total; index++)
+        {
+            entries[index].gains = DEFAULT_GAINS;
+            uint32_t rest = index;
+            for (const SweepParam& param : params)
+            {
+                uint32_t step = rest % param.steps;
+                rest /= param.steps;
+                gain_ref (entries[index].gains, param.controller, param.gain)
+                    = (param.steps > 1)
+                      ? param.low + (param.high - param.low) * step / (param.steps - 1)
+                      : param.low;
+            }
+        }
+    }
+
+    // Every gain set is flown in the same trials
+    std::vector<SimConfig> trials;
+    for (uint32_t trial = 0; trial < trial_count; trial++)
+    {
+        trials.push_back (make_trial (random));
+    }
+
+    // One job per flight. Each writes only its own score, so no locking
+    std::vector<SimResult> results (entries.size () * trial_count);
+    auto start = std::chrono::steady_clock::now ();
+    uint64_t steals;
+    uint32_t threads_used;
+    {
+        ThreadPool pool (thread_count);
+        for (uint32_t set = 0; set < entries.size (); set++)
+        {
+            for (uint32_t trial = 0; trial < trial_count; trial++)
+            {
+                pool.submit ([&, set, trial] (void)
+                {
+                    SimConfig config = trials[trial];
+                    config.gains = entries[set].gains;
+                    results[set * trial_count + trial] = Simulation (config).run ();
+                });
+            }
+        }
+        pool.wait ();
+        steals = pool.get_steals ();
+        threads_used = pool.size ();
+    }
+    auto stop = std::chrono::steady_clock::now ();
+    double wall = std::chrono::duration<double> (stop - start).count ();
+
+    // Sum up each gain set's trials, then rank the sets
+    double simulated = 0;
+    for (uint32_t set = 0; set < entries.size (); set++)
+    {
+        SweepEntry& entry = entries[set];
+        entry.score = entry.worst = entry.settling = 0;
+        entry.overshoot = entry.touchdown_pitch = 0;
+        entry.failures = 0;
+        for (uint32_t trial = 0; trial < trial_count; trial++)
+        {
+            const SimResult& result = results[set * trial_count + trial];
+            float score = score_flight (result, weights);
+            simulated += result.flight_time;
+            entry.score += score;
+            entry.worst = std::max (entry.worst, score);
+            entry.settling += result.settling_time;
+            entry.overshoot += result.overshoot;
+            entry.touchdown_pitch += result.touchdown_pitch;
+            if (score >= SWEEP_FAILED_SCORE)
+            {
+                entry.failures++;
+            }
+        }
+        entry.score /= trial_count;
+        entry.settling /= trial_count;
+        entry.overshoot /= trial_count;
+        entry.touchdown_pitch /= trial_count;
+    }
+    std::stable_sort (entries.begin (), entries.end (),
+                      [] (const SweepEntry& a, const SweepEntry& b)
+                      {
+                          return a.score < b.score
+                                 || (a.score == b.score && a.worst < b.worst);
+                      });
+
+    print_header (stdout);
+    for (uint32_t rank = 0; rank < top && rank < entries.size (); rank++)
+    {
+        print_entry (stdout, rank + 1, entries[rank]);
+    }
+    if (out_name)
+    {
+        FILE* p_file = fopen (out_name, "w");
+        if (!p_file)
+        {
+            perror (out_name);
+            return 1;
+        }
+        print_header (p_file);
+        for (uint32_t rank = 0; rank < entries.size (); rank++)
+        {
+            print_entry (p_file, rank + 1, entries[rank]);
+        }
+        fclose (p_file);
+    }
+
+    fprintf (stderr, "%zu flights of %zu gain sets in %.2f s on %u threads, "
+             "%.0f flights/s, %.0f times real time, %llu jobs stolen\n",
+             results.size (), entries.size (), wall, threads_used,
+             results.size () / wall, simulated / wall,
+             (unsigned long long)steals);
+    return 0;
+}
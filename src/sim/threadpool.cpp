@@ -0,0 +1,163 @@
+/** @file    threadpool.cpp
+ *  @brief   Source code for a work-stealing pool of threads which runs many
+ *           small jobs, such as simulated flights, on all of a PC's cores.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#include "threadpool.h"
+
+
+/// Index of the pool thread running this code, or -1 outside the pool
+static thread_local int32_t worker_index = -1;
+
+
+/** @brief   Start a pool of threads.
+ *  @param   thread_count The number of threads, or 0 for one per core
+ */
+ThreadPool::ThreadPool (uint32_t thread_count)
+    : next_queue (0), queued (0), pending (0), steals (0), stopping (false)
+{
+    if (thread_count == 0)
+    {
+        thread_count = std::thread::hardware_concurrency ();
+    }
+    if (thread_count == 0)
+    {
+        thread_count = 1;
+    }
+
+    // All the queues must exist before any thread tries to steal from them
+    for (uint32_t index = 0; index < thread_count; index++)
+    {
+        queues.emplace_back (new WorkQueue);
+    }
+    for (uint32_t index = 0; index < thread_count; index++)
+    {
+        threads.emplace_back (&ThreadPool::work, this, index);
+    }
+}
+
+
+/** @brief   Finish the jobs already submitted, then stop the threads.
+ */
+ThreadPool::~ThreadPool (void)
+{
+    wait ();
+    {
+        std::lock_guard<std::mutex> lock (idle_mutex);
+        stopping = true;
+    }
+    wake.notify_all ();
+    for (std::thread& thread : threads)
+    {
+        thread.join ();
+    }
+}
+
+
+/** @brief   Add a job to be run by one of the threads.
+ *  @details A job submitted from inside a job goes onto that thread's own
+ *           queue, where it is likely to run soon and on the same core;
+ *           other jobs are dealt to the queues in turn.
+ *  @param   job The job
+ */
+void ThreadPool::submit (Job job)
+{
+    uint32_t index = (worker_index >= 0) ? (uint32_t)worker_index
+                                         : next_queue++ % queues.size ();
+    pending++;
+
+    // Count the job while holding the idle mutex so that a thread which is
+    // just going to sleep can't miss it. It is counted before it is queued
+    // so that the count never falls below zero when it is taken at once
+    {
+        std::lock_guard<std::mutex> lock (idle_mutex);
+        queued++;
+    }
+    {
+        std::lock_guard<std::mutex> lock (queues[index]->mutex);
+        queues[index]->jobs.push_back (std::move (job));
+    }
+    wake.notify_one ();
+}
+
+
+/** @brief   Take a job from a thread's own queue, or steal one from another's.
+ *  @param   index The thread's number
+ *  @param   job Set to the job taken, if there was one
+ *  @returns @c true if a job was taken
+ */
+bool ThreadPool::take (uint32_t index, Job& job)
+{
+    // The newest job on a thread's own queue
+    {
+        WorkQueue& own = *queues[index];
+        std::lock_guard<std::mutex> lock (own.mutex);
+        if (!own.jobs.empty ())
+        {
+            job = std::move (own.jobs.back ());
+            own.jobs.pop_back ();
+            queued--;
+            return true;
+        }
+    }
+
+    // The oldest job on someone else's, starting with the next thread along
+    for (uint32_t offset = 1; offset < queues.size (); offset++)
+    {
+        WorkQueue& other = *queues[(index + offset) % queues.size ()];
+        std::lock_guard<std::mutex> lock (other.mutex);
+        if (!other.jobs.empty ())
+        {
+            job = std::move (other.jobs.front ());
+            other.jobs.pop_front ();
+            queued--;
+            steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/** @brief   The loop run by each thread of the pool.
+ *  @details The thread runs jobs while there are any to take, then sleeps
+ *           until another is submitted or the pool is stopped.
+ *  @param   index The thread's number, which is also that of its queue
+ */
+void ThreadPool::work (uint32_t index)
+{
+    worker_index = index;
+    while (true)
+    {
+        Job job;
+        if (take (index, job))
+        {
+            job ();
+            if (--pending == 0)
+            {
+                std::lock_guard<std::mutex> lock (idle_mutex);
+                finished.notify_all ();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock (idle_mutex);
+        wake.wait (lock, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0)
+        {
+            return;
+        }
+    }
+}
+
+
+/** @brief   Wait until every job submitted so far has finished.
+ */
+void ThreadPool::wait (void)
+{
+    std::unique_lock<std::mutex> lock (idle_mutex);
+    finished.wait (lock, [this] { return pending == 0; });
+}
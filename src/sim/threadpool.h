@@ -0,0 +1,85 @@
+/** @file    threadpool.h
+ *  @brief   Headers for a work-stealing pool of threads which runs many
+ *           small jobs, such as simulated flights, on all of a PC's cores.
+ *  @details Each thread has its own queue of jobs. Jobs submitted from
+ *           outside the pool are dealt to the queues in turn, and jobs
+ *           submitted by a job go onto its own thread's queue. A thread takes
+ *           the newest job from its own queue; when that is empty it steals
+ *           the oldest job from another thread's queue. Threads rarely touch
+ *           the same queue, so they seldom wait for each other. A thread that
+ *           has finished its share early doesn't sit idle while another
+ *           still has a backlog, which matters when some jobs, such as a
+ *           flight that crashes early, are much shorter than others.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#ifndef _THREADPOOL_H_
+#define _THREADPOOL_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+
+/** @brief   Class which runs jobs on a work-stealing pool of threads.
+ */
+class ThreadPool
+{
+public:
+    typedef std::function<void (void)> Job;     ///< Something for a thread to do
+
+protected:
+    /// @brief One thread's queue of jobs, with the mutex which guards it
+    struct WorkQueue
+    {
+        std::mutex mutex;               ///< Guards @c jobs
+        std::deque<Job> jobs;           ///< Jobs waiting to be run
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues; ///< One queue per thread
+    std::vector<std::thread> threads;   ///< The threads of the pool
+    std::atomic<uint32_t> next_queue;   ///< Queue for the next outside job
+    std::atomic<uint32_t> queued;       ///< Jobs waiting in all the queues
+    std::atomic<uint32_t> pending;      ///< Jobs submitted and not yet finished
+    std::atomic<uint64_t> steals;       ///< Jobs taken from another's queue
+    bool stopping;                      ///< Whether the threads are to exit
+
+    std::mutex idle_mutex;              ///< Guards sleeping and waking
+    std::condition_variable wake;       ///< Signals that a job was submitted
+    std::condition_variable finished;   ///< Signals that all jobs are done
+
+    // Take a job from a thread's own queue, or steal one from another's
+    bool take (uint32_t index, Job& job);
+
+    // The loop run by each thread of the pool
+    void work (uint32_t index);
+
+public:
+    // Start a pool of threads, by default one per core
+    ThreadPool (uint32_t thread_count = 0);
+
+    // Finish the jobs already submitted, then stop the threads
+    ~ThreadPool (void);
+
+    // Add a job to be run by one of the threads
+    void submit (Job job);
+
+    // Wait until every job submitted so far has finished
+    void wait (void);
+
+    /// Return the number of threads in the pool
+    uint32_t size (void) const { return threads.size (); }
+
+    /// Return the number of jobs which were stolen from another's queue
+    uint64_t get_steals (void) const { return steals; }
+};
+
+#endif // _THREADPOOL_H_
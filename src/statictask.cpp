@@ -0,0 +1,199 @@
+/** @file    statictask.cpp
+ *  @brief   Source code for a class which runs an RTOS task from memory that
+ *           is allocated when the program is compiled.
+ *
+ *  @author ME 507 Airheads, modeled on @c baseshare.cpp by JR Ridgely
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Added JSON output of the task list
+ */
+
+#include "statictask.h"
+#include "PrintStream.h"
+
+
+// Set pointer to most recently created task to initially be NULL
+StaticTask* StaticTask::p_newest = NULL;
+
+
+/** @brief   Save a task's settings and install it in the list of tasks.
+ *  @details This method is called by the constructor, which is a template
+ *           only so that it can find out the size of the stack array.
+ *  @param   p_name The name of the task, shown in task lists
+ *  @param   p_function The function which runs the task
+ *  @param   p_a_stack Pointer to the memory to be used as the stack
+ *  @param   a_stack_size The size of the stack in elements of @c StackType_t,
+ *           which on the ESP32 are bytes
+ *  @param   a_priority The RTOS priority of the task
+ *  @param   a_core The CPU core on which the task is to run
+ */
+void StaticTask::setup_task (const char* p_name, TaskFunction_t p_function,
+                             StackType_t* p_a_stack, uint32_t a_stack_size,
+                             UBaseType_t a_priority, BaseType_t a_core)
+{
+    name = (p_name != NULL) ? p_name : "(No Name)";
+    function = p_function;
+    p_stack = p_a_stack;
+    stack_size = a_stack_size;
+    priority = a_priority;
+    core = a_core;
+    handle = NULL;
+
+    // Install this task in the linked list of tasks
+    p_next = p_newest;
+    p_newest = this;
+}
+
+
+/** @brief   Create the RTOS task and start it running.
+ *  @details The task is created in the stack and control block belonging to
+ *           this object, so no heap memory is used. A task may only be started
+ *           once; further calls do nothing. A priority of
+ *           @c configMAX_PRIORITIES or more is reported, as FreeRTOS would
+ *           lower it to the highest priority without saying so.
+ *  @param   p_params A pointer passed to the task function (default @c NULL)
+ *  @returns @c true if the task is running, @c false if it couldn't be made
+ */
+bool StaticTask::start (void* p_params)
+{
+    if (handle == NULL)
+    {
+        // FreeRTOS would quietly lower a priority which is out of range
+        if (priority >= configMAX_PRIORITIES)
+        {
+            Serial << "Error: task " << name << " priority " << (unsigned)priority
+                   << " not below " << configMAX_PRIORITIES << endl;
+        }
+        handle = xTaskCreateStaticPinnedToCore (function, name, stack_size,
+                                                p_params, priority, p_stack,
+                                                &task_block, core);
+        if (handle == NULL)
+        {
+            Serial << "Error: task " << name << " not started" << endl;
+        }
+    }
+    return handle != NULL;
+}
+
+
+/** @brief   Print one line describing this task's use of its stack.
+ *  @details The high water mark is the least free stack space the task has
+ *           had since it started, so "Used" is the most stack the task has
+ *           ever needed. A task whose free space gets near zero needs a bigger
+ *           stack; one which uses a small fraction of its stack can be given a
+ *           smaller one to save RAM.
+ *  @param   printer Reference to a serial device on which to print
+ */
+void StaticTask::print_in_list (Print& printer)
+{
+    printer.printf ("%-20s%5u%8lu", name, (unsigned)priority,
+                    (unsigned long)stack_size);
+    if (handle != NULL)
+    {
+        uint32_t free_bytes = uxTaskGetStackHighWaterMark (handle);
+        printer.printf ("%8lu%8lu", (unsigned long)(stack_size - free_bytes),
+                        (unsigned long)free_bytes);
+    }
+    else
+    {
+        printer.printf ("%16s", "(not started)");
+    }
+    print_timing (printer);
+    printer.println ();
+
+    // Go to the next task in the list
+    if (p_next != NULL)
+    {
+        p_next->print_in_list (printer);
+    }
+}
+
+
+/** @brief   Print the stack use of every task and the free heap memory.
+ *  @details Tasks are printed in reverse order of construction. Stack sizes
+ *           are in bytes. The heap figures show how much memory is left for
+ *           the things which still come from the heap, such as WiFi buffers.
+ *  @param   printer Reference to a serial device on which to print
+ */
+void print_all_tasks (Print& printer)
+{
+    printer.println ("Task                 Pri.   Stack    Used    Free"
+                     "  Period      Runs  Load%  Min(us)  Avg(us)  P99(us)"
+                     "  Max(us) Jit.(us) Overruns");
+    printer.println ("----                 ----   -----    ----    ----"
+                     "  ------      ----  -----  -------  -------  -------"
+                     "  ------- -------- --------");
+
+    uint32_t total = 0;
+    for (StaticTask* p_task = StaticTask::p_newest; p_task != NULL;
+         p_task = p_task->p_next)
+    {
+        total += p_task->stack_size;
+    }
+    if (StaticTask::p_newest != NULL)
+    {
+        StaticTask::p_newest->print_in_list (printer);
+    }
+    printer.printf ("%-20s%13lu", "Total", (unsigned long)total);
+    printer.println ();
+
+#ifdef ESP32
+    printer.printf ("Heap: %lu bytes free, %lu least free since boot",
+                    (unsigned long)ESP.getFreeHeap (),
+                    (unsigned long)ESP.getMinFreeHeap ());
+    printer.println ();
+#endif
+}
+
+
+/** @brief   Print this task's stack use and timing as a JSON object.
+ *  @details Stack sizes are in bytes. A task which hasn't been started has
+ *           no stack use to show, so its @c "stack_used" is @c null.
+ *  @param   printer Reference to a serial device on which to print
+ */
+void StaticTask::print_json (Print& printer)
+{
+    printer.printf ("{\"name\":\"%s\",\"priority\":%u,\"core\":%d"
+                    ",\"stack\":%lu", name, (unsigned)priority,
+                    (core == tskNO_AFFINITY) ? -1 : (int)core,
+                    (unsigned long)stack_size);
+    if (handle != NULL)
+    {
+        printer.printf (",\"stack_used\":%lu", (unsigned long)(stack_size
+                        - uxTaskGetStackHighWaterMark (handle)));
+    }
+    else
+    {
+        printer.printf (",\"stack_used\":null");
+    }
+    print_timing_json (printer);
+    printer.printf ("}");
+}
+
+
+/** @brief   Print the stack use and timing of every task and the free heap
+ *           memory as a JSON object.
+ *  @details The object has the time since startup in milliseconds, the heap
+ *           figures in bytes and an array @c "tasks" with one object per
+ *           task, in the same order as the table from @c print_all_tasks().
+ *  @param   printer Reference to a serial device on which to print
+ */
+void print_all_tasks_json (Print& printer)
+{
+    printer.printf ("{\"uptime_ms\":%lu", (unsigned long)millis ());
+#ifdef ESP32
+    printer.printf (",\"heap_free\":%lu,\"heap_min_free\":%lu",
+                    (unsigned long)ESP.getFreeHeap (),
+                    (unsigned long)ESP.getMinFreeHeap ());
+#endif
+    printer.printf (",\"tasks\":[");
+    for (StaticTask* p_task = StaticTask::p_newest; p_task != NULL;
+         p_task = p_task->p_next)
+    {
+        p_task->print_json (printer);
+        if (p_task->p_next != NULL)
+        {
+            printer.printf (",");
+        }
+    }
+    printer.printf ("]}");
+}
@@ -0,0 +1,130 @@
+/** @file    statictask.h
+ *  @brief   Headers for a class which runs an RTOS task from memory that is
+ *           allocated when the program is compiled.
+ *  @details @c xTaskCreate() takes each task's stack and control block from
+ *           the heap while the program runs, and the stack sizes are guesses
+ *           which nobody ever checks. A @c StaticTask is given a stack array
+ *           declared as a global variable, so the memory used by all the tasks
+ *           is fixed and shows up in the linker's RAM totals. All the tasks
+ *           are kept in a linked list, as shares are, so that
+ *           @c print_all_tasks() can report how much of its stack each task
+ *           has actually used.
+ *
+ *  @author ME 507 Airheads, modeled on @c baseshare.h by JR Ridgely
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Added JSON output of the task list
+ */
+
+// This define prevents this .h file from being included more than once
+#ifndef _STATICTASK_H_
+#define _STATICTASK_H_
+
+#include <Arduino.h>
+
+
+/** @brief   Class for an RTOS task whose stack and control block are
+ *           allocated statically.
+ *  @details The constructor only records the task's settings; the task is
+ *           created when @c start() is called, usually from @c setup().
+ *
+ *           @section usage_statictask Usage
+ *           @code{.cpp}
+ *           #include "statictask.h"
+ *           ...
+ *           /// Stack for the antler-watching task
+ *           StackType_t antler_stack[2048];
+ *
+ *           /// The antler-watching task, at priority 5
+ *           StaticTask antler_task ("Antlers", task_antlers, antler_stack, 5);
+ *           ...
+ *           void setup (void)
+ *           {
+ *               antler_task.start ();
+ *           }
+ *           @endcode
+ */
+class StaticTask
+{
+protected:
+    const char* name;                   ///< Name shown in task lists
+    TaskFunction_t function;            ///< Function which runs the task
+    StackType_t* p_stack;               ///< The task's stack
+    uint32_t stack_size;                ///< Size of the stack in bytes
+    UBaseType_t priority;               ///< RTOS priority of the task
+    BaseType_t core;                    ///< CPU core, or @c tskNO_AFFINITY
+    StaticTask_t task_block;            ///< Memory for the task control block
+    TaskHandle_t handle;                ///< Handle of the task once started
+
+    /// Pointer to the next task in the list; the list goes backwards
+    StaticTask* p_next;
+
+    /// Pointer to the most recently constructed task, the head of the list
+    static StaticTask* p_newest;
+
+    // Record the settings and put the task in the list of tasks
+    void setup_task (const char* p_name, TaskFunction_t p_function,
+                     StackType_t* p_a_stack, uint32_t a_stack_size,
+                     UBaseType_t a_priority, BaseType_t a_core);
+
+    /** @brief   Print timing columns in the list of tasks.
+     *  @details Descendents which keep timing statistics override this
+     *           method; a plain @c StaticTask has none to print.
+     *  @param   printer Reference to a serial device on which to print
+     */
+    virtual void print_timing (Print& printer) { }
+
+    /** @brief   Print timing fields in this task's JSON object.
+     *  @details Descendents which keep timing statistics override this
+     *           method, printing each field with a comma before it.
+     *  @param   printer Reference to a serial device on which to print
+     */
+    virtual void print_timing_json (Print& printer) { }
+
+public:
+    /** @brief   Construct a task which will run with the given stack.
+     *  @details The size of the stack is taken from the array's type, so it
+     *           can't be given wrongly.
+     *  @param   p_name The name of the task, shown in task lists
+     *  @param   p_function The function which runs the task
+     *  @param   stack An array, usually a global variable, used as the stack
+     *  @param   a_priority The RTOS priority of the task
+     *  @param   a_core The CPU core on which the task is to run (default:
+     *           @c tskNO_AFFINITY, either core)
+     */
+    template <size_t size>
+    StaticTask (const char* p_name, TaskFunction_t p_function,
+                StackType_t (&stack)[size], UBaseType_t a_priority,
+                BaseType_t a_core = tskNO_AFFINITY)
+    {
+        setup_task (p_name, p_function, stack, size, a_priority, a_core);
+    }
+
+    // Create the RTOS task and start it running
+    bool start (void* p_params = NULL);
+
+    /** @brief   Return the handle of the RTOS task.
+     *  @returns The task's handle, or @c NULL if it hasn't been started
+     */
+    TaskHandle_t get_handle (void)
+    {
+        return handle;
+    }
+
+    // Print this task's stack use within a list of all tasks
+    virtual void print_in_list (Print& printer);
+
+    // Print this task's stack use and timing as a JSON object
+    void print_json (Print& printer);
+
+    friend void print_all_tasks (Print& printer);
+    friend void print_all_tasks_json (Print& printer);
+};
+
+
+// Function that prints the stack use of every task and the free heap memory
+void print_all_tasks (Print& printer);
+
+// Function that prints the same information as print_all_tasks() in JSON
+void print_all_tasks_json (Print& printer);
+
+#endif // _STATICTASK_H_
@@ -0,0 +1,37 @@
+/** @file    surfaceio.h
+ *  @brief   Interface between the surface loop and the hardware which moves
+ *           and measures the control surfaces.
+ *  @details On the glider the surfaces are moved by DRV8871 motor drivers and
+ *           measured by potentiometers; in the simulator they are a model of
+ *           the motors and linkages. The surface loop only uses this
+ *           interface, so it runs unchanged against either one.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ */
+
+#ifndef _SURFACEIO_H_
+#define _SURFACEIO_H_
+
+#include <Arduino.h>
+
+
+/** @brief   Class for the motors and angle sensors of the control surfaces.
+ *  @details Surfaces are numbered as in @c SurfaceAxis.
+ */
+class SurfaceIO
+{
+public:
+    virtual ~SurfaceIO (void) { }
+
+    /// Return the angle of a surface (deg)
+    virtual float get_angle (uint8_t axis) = 0;
+
+    /// Make the present angle of a surface read as zero
+    virtual void zero (uint8_t axis) = 0;
+
+    /// Drive a surface's motor at a duty cycle from -100% to 100%
+    virtual void set_duty (uint8_t axis, int16_t duty) = 0;
+};
+
+#endif // _SURFACEIO_H_
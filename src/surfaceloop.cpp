@@ -0,0 +1,163 @@
+/** @file    surfaceloop.cpp
+ *  @brief   Source code for the fast loop which holds the control surfaces at
+ *           the angles the attitude controller wants.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file, from the loop in @c task_surfaces
+ */
+
+#include "surfaceloop.h"
+
+
+/** @brief   Create a surface loop with the default gains.
+ *  @param   dt The nominal time between runs (ms)
+ */
+SurfaceLoop::SurfaceLoop (float dt)
+    : surface_bank (dt)
+{
+    for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
+    {
+        surface_bank.set_limits (axis, -100, 100);
+        surface_bank.set_filter (axis, SURFACE_D_FILTER_MS);
+        prev_angle[axis] = 0;
+        output[axis] = 0;
+    }
+    set_gains (DEFAULT_GAINS);
+    memset (&tune_result, 0, sizeof (tune_result));
+    tune_axis = SURFACE_AXES;
+    tune_finished = false;
+}
+
+
+/** @brief   Stop the motors and zero the angle sensors.
+ *  @param   io The motors and angle sensors
+ */
+void SurfaceLoop::begin (SurfaceIO& io)
+{
+    for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
+    {
+        io.set_duty (axis, 0);
+        io.zero (axis);
+        prev_angle[axis] = io.get_angle (axis);
+    }
+}
+
+
+/** @brief   Use a new set of gains.
+ *  @param   gains The gains, of which the surface loop's are used
+ */
+void SurfaceLoop::set_gains (const GainSet& gains)
+{
+    for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
+    {
+        surface_bank.set_gains (axis, gains.surface[axis].Kp,
+                                gains.surface[axis].Ki, gains.surface[axis].Kd);
+    }
+}
+
+
+/** @brief   Run the autotuner once and return the duty cycle for the surface.
+ *  @details Each surface in turn is swung about zero. When the last has been
+ *           tuned, the results are kept until autotuning is asked for again.
+ *  @param   state The surface angles measured in this run
+ *  @param   time_us The present time (us)
+ *  @param   finished Set to @c true if the last surface has just been tuned
+ *  @returns The duty cycle for surface @c tune_axis
+ */
+int16_t SurfaceLoop::run_autotune (const SurfaceState& state, uint32_t time_us,
+                                   bool& finished)
+{
+    if (tune_finished)
+    {
+        return 0;
+    }
+    if (tune_axis >= SURFACE_AXES)
+    {
+        tune_axis = 0;
+        tuner.start (0, time_us);
+    }
+
+    int16_t duty = tuner.step (state.angle[tune_axis], time_us);
+    if (tuner.get_status () != TUNE_RUNNING)
+    {
+        tune_result.status[tune_axis] = tuner.get_status ();
+        tune_result.ultimate_gain[tune_axis] = tuner.get_ultimate_gain ();
+        tune_result.ultimate_period[tune_axis] = tuner.get_ultimate_period ();
+        tune_result.gains[tune_axis] = tuner.get_gains ();
+
+        if (++tune_axis < SURFACE_AXES)
+        {
+            tuner.start (0, time_us);
+        }
+        else
+        {
+            tune_finished = true;
+            finished = true;
+        }
+    }
+    return duty;
+}
+
+
+/** @brief   Run the surface loop once.
+ *  @param   io The motors and angle sensors
+ *  @param   setpoint The surface angles wanted by the attitude controller
+ *  @param   time_us The present time, such as from @c micros()
+ *  @param   state Filled with the surface angles and the duty cycles
+ *  @returns @c true if an autotune has just finished, in which case its
+ *           results are given by @c get_tune_result()
+ */
+bool SurfaceLoop::run (SurfaceIO& io, const SurfaceSetpoint& setpoint,
+                       uint32_t time_us, SurfaceState& state)
+{
+    for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
+    {
+        state.angle[axis] = io.get_angle (axis);
+    }
+
+    // Keep the controllers from integrating while the motors are off
+    if (setpoint.active)
+    {
+        surface_bank.update (state.angle, setpoint.angle, output, time_us);
+    }
+    else
+    {
+        surface_bank.reset ();
+    }
+
+    // Autotune one surface at a time, swinging it about its center
+    bool finished = false;
+    int16_t tune_duty = 0;
+    if (setpoint.autotune)
+    {
+        tune_duty = run_autotune (state, time_us, finished);
+    }
+    else
+    {
+        tune_finished = false;
+        tune_axis = SURFACE_AXES;
+    }
+
+    // Only drive a surface if its angle changed by a believable amount, to
+    // prevent undesired response to flickering measurements
+    for (uint8_t axis = 0; axis < SURFACE_AXES; axis++)
+    {
+        if (setpoint.autotune)
+        {
+            state.duty[axis] = (axis == tune_axis) ? tune_duty : 0;
+        }
+        else if (setpoint.active
+                 && fabs (state.angle[axis] - prev_angle[axis]) < SURFACE_GLITCH_ANGLE)
+        {
+            state.duty[axis] = (int16_t)round (output[axis]);
+        }
+        else
+        {
+            state.duty[axis] = 0;
+        }
+        io.set_duty (axis, state.duty[axis]);
+        prev_angle[axis] = state.angle[axis];
+    }
+
+    return finished;
+}
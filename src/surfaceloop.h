@@ -0,0 +1,69 @@
+/** @file    surfaceloop.h
+ *  @brief   Headers for the fast loop which holds the control surfaces at
+ *           the angles the attitude controller wants.
+ *  @details As with @c FlightController, the logic is kept apart from the
+ *           task which runs it, and the hardware is reached through a
+ *           @c SurfaceIO, so the simulator runs the same code as the glider.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file, from the loop in @c task_surfaces
+ */
+
+#ifndef _SURFACELOOP_H_
+#define _SURFACELOOP_H_
+
+#include <Arduino.h>
+#include "surfaces.h"
+#include "gains.h"
+#include "pidbank.h"
+#include "relaytuner.h"
+#include "surfaceio.h"
+
+
+/// Largest change in a surface's angle between runs which is believed (deg)
+#define SURFACE_GLITCH_ANGLE 30
+
+
+/** @brief   Class which runs the surface position loops.
+ *  @details Each run reads the surface angles, runs one controller per
+ *           surface against the setpoint and drives the motors. A surface
+ *           whose angle jumps by more than @c SURFACE_GLITCH_ANGLE between
+ *           runs isn't driven, so that a flickering potentiometer doesn't
+ *           make the motor lurch. When the setpoint asks for autotuning, the
+ *           surfaces are tuned one at a time by relay feedback instead.
+ */
+class SurfaceLoop
+{
+protected:
+    PIDBank<SURFACE_AXES> surface_bank; ///< Surface angle to motor duty cycle
+    float prev_angle[SURFACE_AXES];     ///< Surface angles at the previous run (deg)
+    float output[SURFACE_AXES];         ///< Controller outputs, limited to +/-100%
+
+    RelayTuner tuner;                   ///< Autotuner for one surface at a time
+    TuneResult tune_result;             ///< Results of autotuning each surface
+    uint8_t tune_axis;                  ///< Surface being tuned, if less than SURFACE_AXES
+    bool tune_finished;                 ///< Whether autotuning has finished
+
+    // Run the autotuner once and return the duty cycle for the surface
+    int16_t run_autotune (const SurfaceState& state, uint32_t time_us,
+                          bool& finished);
+
+public:
+    // Create a surface loop with the default gains
+    SurfaceLoop (float dt);
+
+    // Stop the motors and zero the angle sensors
+    void begin (SurfaceIO& io);
+
+    // Use a new set of gains
+    void set_gains (const GainSet& gains);
+
+    // Run the surface loop once
+    bool run (SurfaceIO& io, const SurfaceSetpoint& setpoint,
+              uint32_t time_us, SurfaceState& state);
+
+    /// Return the results of the last autotune
+    const TuneResult& get_tune_result (void) const { return tune_result; }
+};
+
+#endif // _SURFACELOOP_H_
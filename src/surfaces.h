@@ -0,0 +1,51 @@
+/** @file surfaces.h
+ *  @brief This file contains the structures which pass control surface
+ *         angles between the attitude controller and the fast loop which
+ *         moves the surfaces.
+ *
+ *  @author ME 507 Airheads
+ *  @date   2026-Oct-16 Original file
+ *  @date   2026-Oct-16 Angles and duty cycles kept in arrays indexed by axis
+ *  @date   2026-Oct-16 Setpoint can ask the surface loop to autotune itself
+ */
+
+#ifndef _SURFACES_H_
+#define _SURFACES_H_
+
+#include <Arduino.h>
+
+/** @brief  The control surfaces, used to index the arrays of angles and duty
+ *          cycles. An axis is added by putting it before @c SURFACE_AXES.
+ */
+enum SurfaceAxis
+{
+    RUDDER_AXIS = 0,        ///< The rudder
+    ELEVATOR_AXIS,          ///< The elevator
+    SURFACE_AXES            ///< The number of control surfaces
+};
+
+/** @brief  The surface angles wanted by the attitude controller.
+ *  @details The surface loop holds the surfaces at these angles until the
+ *           controller sends new ones. The setpoint carries the time of the
+ *           IMU sample from which it was calculated, so the surface loop can
+ *           measure how long it took for the sample to reach the motors.
+ *           Setpoints which weren't calculated from a new IMU sample have a
+ *           sample time of zero.
+ */
+struct SurfaceSetpoint
+{
+    bool active;            ///< Whether the motors are to be driven at all
+    bool autotune;          ///< Whether to tune the surface loop instead
+    float angle[SURFACE_AXES];  ///< Desired surface angles (deg)
+    uint32_t sample_us;     ///< Time of the IMU sample used, or 0 (us)
+};
+
+/** @brief  The surface angles and motor duty cycles from the surface loop.
+ */
+struct SurfaceState
+{
+    float angle[SURFACE_AXES];      ///< Measured surface angles (deg)
+    int16_t duty[SURFACE_AXES];     ///< Motor duty cycles (-100% to 100%)
+};
+
+#endif // _SURFACES_H_
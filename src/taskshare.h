@@ -21,6 +21,9 @@
  *  @date 2020-Nov-18 JRR Critical sections not reliable; changed to a queue
  *  @date 2021-Sep-17 JRR Changed some @c put params from references to copies
  *  @date 2021-Sep-19 JRR Added overloads for @c get() which return values
+ *  @date 2026-Oct-16 Added update versions, @c get_if_newer() and
+ *                    @c wait_for_update() so consumers can block on new data
+ *  @date 2026-Oct-16 Queue memory allocated statically, not from the heap
  *
  *  @copyright This file is copyright 2014 -- 2021 by JR Ridgely and released 
  *    under the Lesser GNU Public License, version 2. It intended for 
@@ -41,6 +44,7 @@
 #ifndef _TASKSHARE_H_
 #define _TASKSHARE_H_
 
+#include <atomic>
 #include "baseshare.h"                      // Base class for shared data items
 #include <PrintStream.h>                    // Needed for endl
 //#include "FreeRTOS.h"                     // Main header for FreeRTOS, not needed for ESP32
@@ -116,33 +120,97 @@
  *           ...
  *           my_share >> got_data;          // In receiving task
  *           @endcode
+ *
+ *           @b Waiting @b for @b new @b data
+ *           Every @c put() gives the data a new version number. A task which
+ *           only has work to do when the data changes can sleep until the next
+ *           @c put() and then fetch the data only if it is newer than the
+ *           version it last used. The number of versions since then is also
+ *           returned, so the task can tell how many updates it missed:
+ *           @code
+ *           uint32_t version = 0;          ///< Last version of data used
+ *           ...
+ *           my_share.wait_for_update (100);             // Sleep up to 100 ms
+ *           uint32_t updates = my_share.get_if_newer (got_data, version);
+ *           if (updates > 0)
+ *           {
+ *               use (got_data);            // updates - 1 were never seen
+ *           }
+ *           @endcode
+ *           Waking is done with a FreeRTOS task notification, so only one
+ *           task at a time should wait for updates to a given share.
  */
 template <class DataType> class Share : public BaseShare
 {
 protected:
+    /// @brief  The contents of the queue: the data and its version number
+    struct Item
+    {
+        DataType data;                      ///< The shared data
+        uint32_t version;                   ///< Number of the put() which wrote it
+    };
+
     /// A queue is used to hold the data, as it's portable to different CPU's
     QueueHandle_t queue;
 
+    /// Storage for the queue's one item, so the queue needs no heap memory
+    uint8_t queue_storage[sizeof (Item)];
+
+    /// Storage for the queue's control block
+    StaticQueue_t queue_block;
+
+    /// The number of times data has been put into the share
+    std::atomic<uint32_t> puts;
+
+    /// The task, if any, which is woken up when new data is put in the share
+    TaskHandle_t volatile waiting_task;
+
+    /** @brief   Make a queue item holding new data and the next version.
+     *  @param   new_data The data which is to be written
+     *  @returns An item ready to be written into the queue
+     */
+    Item make_item (DataType new_data)
+    {
+        Item item;
+        item.data = new_data;
+        item.version = puts.fetch_add (1) + 1;
+        count_put ();
+        return item;
+    }
+
 public:
     /** @brief   Construct a shared data item.
      *  @details This constructor for a shared data item creates a queue in 
-     *           which to hold one item of data. Note that the data is @b not 
+     *           which to hold one item of data. The queue's memory is part of
+     *           this object, so a share declared as a global variable takes
+     *           no memory from the heap. Note that the data is @b not 
      *           initialized. 
      *  @param   p_name A name to be shown in the list of task shares 
      *           (default @c NULL)
      */
     Share<DataType> (const char* p_name = NULL) : BaseShare (p_name)
     {
-        queue = xQueueCreate (1, sizeof (DataType));
+        queue = xQueueCreateStatic (1, sizeof (Item), queue_storage, 
+                                    &queue_block);
+        puts.store (0);
+        waiting_task = NULL;
     }
 
     /** @brief   Put data into the shared data item.
      *  @details This method is used to write data into the shared data item. 
+     *           If a task is waiting for an update, it is notified.
      *  @param   new_data The data which is to be written
      */
     void put (DataType new_data)
     {
-        xQueueOverwrite (queue, &new_data);
+        Item item = make_item (new_data);
+        xQueueOverwrite (queue, &item);
+
+        TaskHandle_t task = waiting_task;
+        if (task != NULL)
+        {
+            xTaskNotifyGive (task);
+        }
     }
 
     /** @brief   Put data into the shared data item from within an ISR.
@@ -153,8 +221,16 @@ public:
      */
     void ISR_put (DataType new_data)
     {
-        BaseType_t wake_up;
-        xQueueOverwriteFromISR (queue, &new_data, &wake_up);
+        BaseType_t wake_up = pdFALSE;
+        Item item = make_item (new_data);
+        xQueueOverwriteFromISR (queue, &item, &wake_up);
+
+        TaskHandle_t task = waiting_task;
+        if (task != NULL)
+        {
+            vTaskNotifyGiveFromISR (task, &wake_up);
+        }
+        portYIELD_FROM_ISR (wake_up);
     }
 
     /** @brief   Operator which inserts data into the share.
@@ -170,12 +246,11 @@ public:
     {
         if (CHECK_IF_IN_ISR ())
         {
-            BaseType_t wake_up;
-            xQueueOverwriteFromISR (queue, &new_data, &wake_up);
+            ISR_put (new_data);
         }
         else
         {
-            xQueueOverwrite (queue, &new_data);
+            put (new_data);
         }
     }
 
@@ -193,16 +268,15 @@ public:
      *  @param   put_here A reference to the variable in which to put received
      *           data
      */
-    void operator >> (DataType put_here)
+    void operator >> (DataType& put_here)
     {
         if (CHECK_IF_IN_ISR ())
         {
-            // Copy the data from the queue into the receiving variable
-            xQueuePeekFromISR (queue, &put_here);
+            ISR_get (put_here);
         }
         else
         {
-            xQueuePeek (queue, &put_here, portMAX_DELAY);
+            get (put_here);
         }
     }
 
@@ -217,8 +291,12 @@ public:
      */
     void get (DataType& recv_data)
     {
+        Item item;
+
         // Copy the data from the queue into the receiving variable
-        xQueuePeek (queue, &recv_data, portMAX_DELAY);
+        xQueuePeek (queue, &item, portMAX_DELAY);
+        recv_data = item.data;
+        count_get ();
     }
 
     /** @brief   Read and return data from the shared data item.
@@ -230,12 +308,13 @@ public:
      */
     DataType get (void)
     {
-        DataType return_this;
+        Item item;
     
         // Copy the data from the queue into the receiving variable
-        xQueuePeek (queue, &return_this, portMAX_DELAY);
+        xQueuePeek (queue, &item, portMAX_DELAY);
+        count_get ();
 
-        return return_this;
+        return item.data;
     }
 
     /** @brief   Read data from the shared data item, from within an ISR.
@@ -247,7 +326,12 @@ public:
      */
     void ISR_get (DataType& recv_data)
     {
-        xQueuePeekFromISR (queue, &recv_data);
+        Item item;
+        if (xQueuePeekFromISR (queue, &item))
+        {
+            recv_data = item.data;
+            count_get ();
+        }
     }
 
     /** @brief   Read and return data from the shared data item, from within an
@@ -260,9 +344,69 @@ public:
      */
     DataType ISR_get (void)
     {
-        DataType return_this;
-        xQueuePeekFromISR (queue, &return_this);
-        return return_this;
+        Item item;
+        xQueuePeekFromISR (queue, &item);
+        count_get ();
+        return item.data;
+    }
+
+    /** @brief   Read data from the share only if it is newer than a version
+     *           the caller already has.
+     *  @details This method never blocks. If the share holds data written
+     *           after @c version, the data is copied into @c recv_data and
+     *           @c version is updated to the version of that data. Otherwise
+     *           neither parameter is changed.
+     *  @param   recv_data A reference to the variable in which to put received
+     *           data
+     *  @param   version A reference to the version of the data the caller
+     *           last used; start with 0, which is older than any data
+     *  @returns The number of puts since @c version, or 0 if there is no new
+     *           data. A number greater than 1 means that the caller missed
+     *           that many updates, less one
+     */
+    uint32_t get_if_newer (DataType& recv_data, uint32_t& version)
+    {
+        Item item;
+        if (xQueuePeek (queue, &item, 0) != pdTRUE || item.version == version)
+        {
+            return 0;
+        }
+
+        // With two writers an older version can overwrite a newer one; the
+        // difference is then negative, and the caller's version is kept
+        int32_t updates = (int32_t)(item.version - version);
+        if (updates <= 0)
+        {
+            return 0;
+        }
+        recv_data = item.data;
+        version = item.version;
+        count_get ();
+        return (uint32_t)updates;
+    }
+
+    /** @brief   Block the calling task until data is put into the share.
+     *  @details The calling task becomes the one task which this share wakes
+     *           up with a task notification when data is put into it. The
+     *           notification is kept if data arrives while the task is busy,
+     *           so an update between calls to @c get_if_newer() and this
+     *           method is not lost. It must not be called from an ISR.
+     *  @param   timeout The longest time to wait, in RTOS ticks
+     *  @returns @c true if the task was woken by new data, @c false if the
+     *           wait timed out
+     */
+    bool wait_for_update (TickType_t timeout = portMAX_DELAY)
+    {
+        waiting_task = xTaskGetCurrentTaskHandle ();
+        return ulTaskNotifyTake (pdTRUE, timeout) > 0;
+    }
+
+    /** @brief   Return the version of the newest data in the share.
+     *  @returns The number of times data has been put into the share
+     */
+    uint32_t get_version (void)
+    {
+        return puts.load ();
     }
 
     // Print the share's status within a list of all shares' statuses
@@ -271,22 +415,23 @@ public:
 }; // class TaskShare<DataType>
 
 
-/** @brief   Print the name and type (share) of this data item.
+/** @brief   Print the name, type (share) and statistics of this data item.
  *  @details This method prints the share's name and a word indicating that it
  *           is a shared data item, as opposed to a queue, formatted to match
- *           similar printouts from other task shares such as queues. After
- *           printing this share's information, it looks in the linked list of
- *           shares for the next one and asks it to print its information too.
+ *           similar printouts from other task shares such as queues, followed
+ *           by its put/get statistics. After printing this share's 
+ *           information, it looks in the linked list of shares for the next 
+ *           one and asks it to print its information too.
  *  @param   printer Reference to a serial device on which to print the status
  */
 template <class DataType>
 void Share<DataType>::print_in_list (Print& printer)
 {
     // Print this task's name and pad it to 16 characters
-    printer.printf ("%-16sshare\t", name);
+    printer.printf ("%-16s%-10s%9s", name, "share", "");
 
-    // End the line
-    printer << endl;
+    // Print the statistics and end the line
+    print_stats (printer);
 
     // Call the next item
     if (p_next != NULL)
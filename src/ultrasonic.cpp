@@ -9,6 +9,7 @@
  *  @author Arielle Sampson
  *  @date 2019-Sept-17 Original file
  *  @date 2022-Nov-30 Modified for Airheads Glider Project use by Li and Sampson
+ *  @date 2026-Oct-16 Limited the wait for an echo to the sensor's range
  *  @copyright 2019 by the author
  */
 
@@ -31,6 +32,11 @@ Ultrasonic::Ultrasonic(uint8_t echo, uint8_t trig)
 }
 
 /** @brief   Measure the distance between the sensor and the object in front of it
+ *  @details @c pulseIn() busy-waits for the echo, so the wait is limited to
+ *           the time sound takes to go to the sensor's farthest range and
+ *           back. Without a limit it waits a whole second when the sensor is
+ *           unplugged. If no echo comes back, nothing is in range and the
+ *           sensor's farthest range is returned.
  *  @returns The distance, in centimeters, between the sensor and the object in front of it
  */
 float Ultrasonic::get_distance (void)
@@ -48,7 +54,11 @@ float Ultrasonic::get_distance (void)
     digitalWrite(trigPin, LOW);
 
     // Reads the echoPin, returns the sound wave travel time in microseconds
-    duration = pulseIn(echoPin, HIGH);
+    duration = pulseIn(echoPin, HIGH, ULTRASONIC_TIMEOUT_US);
+    if (duration == 0)
+    {
+        return ULTRASONIC_MAX_RANGE;
+    }
 
     // Calculating the distance
     distance = duration * 0.034 / 2; // Speed of sound wave divided by 2 (go and back)
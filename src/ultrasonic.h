@@ -12,6 +12,13 @@
 
 #include <Arduino.h>
 
+/// Farthest distance the HC-SR04 can measure (cm)
+#define ULTRASONIC_MAX_RANGE 400
+
+/// Longest wait for an echo (us): the round trip at the sensor's full range,
+/// 2 * 400 cm / 0.034 cm/us = 23.5 ms, with a little to spare
+#define ULTRASONIC_TIMEOUT_US 25000
+
 /** @brief  Class for an HC_SR04 Ultrasonic Sensor
  */
 class Ultrasonic //This class operates an HC_SR04 Ultrasonic Sensor 